@@ -0,0 +1,62 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+// Gasirea fisierelor aplicatiei (shadere, texturi) indiferent de directorul curent.
+// Se cauta, in ordine: langa executabil, in directorul curent si in CUBE_ASSET_DIR
+// (directorul cu sursele, definit de CMake).
+
+inline std::string& ExecutableDirStorage()
+{
+	static std::string strExeDir;
+	return strExeDir;
+}
+
+inline void InitAssetPaths(const char* argv0)
+{
+	std::string strFullExeFileName = argv0 ? argv0 : "";
+
+#if defined(__linux__)
+	char buffer[4096];
+	const ssize_t length = readlink("/proc/self/exe", buffer, sizeof(buffer) - 1);
+	if (length > 0)
+		strFullExeFileName.assign(buffer, (size_t)length);
+#endif
+
+	const size_t lastSlashIdx = strFullExeFileName.find_last_of("/\\");
+	ExecutableDirStorage() = lastSlashIdx != std::string::npos ? strFullExeFileName.substr(0, lastSlashIdx) : std::string();
+}
+
+inline const std::string& GetExecutableDir()
+{
+	return ExecutableDirStorage();
+}
+
+inline bool FileExists(const std::string& strPath)
+{
+	std::ifstream file(strPath);
+	return file.good();
+}
+
+inline std::string ResolveAssetPath(const std::string& strName)
+{
+	const std::string& strExeDir = GetExecutableDir();
+	if (!strExeDir.empty() && FileExists(strExeDir + "/" + strName))
+		return strExeDir + "/" + strName;
+
+	if (FileExists(strName))
+		return strName;
+
+#ifdef CUBE_ASSET_DIR
+	const std::string strAssetPath = std::string(CUBE_ASSET_DIR) + "/" + strName;
+	if (FileExists(strAssetPath))
+		return strAssetPath;
+#endif
+
+	return strName;
+}
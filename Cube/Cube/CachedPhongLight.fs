@@ -0,0 +1,108 @@
+#version 330 core
+layout(location = 0) out vec4 FragColor;
+layout(location = 1) out vec4 CachedIrradiance;
+layout(location = 2) out vec4 CacheKey;
+layout(location = 3) out vec2 CacheStats;
+
+in vec3 Normal;
+in vec3 FragPos;
+in vec3 objectColor;
+in vec4 PrevClipPos;
+
+#include "PhongShading.glsl"
+
+// lumini de umplere statice: xyz = pozitia, w = intensitatea
+const int MAX_FILL_LIGHTS = 64;
+uniform int fillLightCount = 0;
+uniform vec4 fillLights[MAX_FILL_LIGHTS];
+
+// istoricul cadrului anterior (vezi TemporalCache.h)
+uniform sampler2D historyIrradiance;
+uniform sampler2D historyKey;
+uniform bool reuseHistory = false;
+// pozitia luminii principale in spatiul obiectului desenat; se schimba cand se misca lumina sau obiectul
+uniform vec3 lightKey;
+uniform float depthTolerance = 0.01;
+uniform float lightTolerance = 0.02;
+// normala istoricului trebuie sa fie aproape aceeasi, altfel pixelul vine de pe fata vecina
+const float NORMAL_TOLERANCE = 0.9;
+
+// Normala impachetata octaedric pe 5+5 biti, ca sa incapa exact in alpha unei tinte RGBA16F.
+vec2 SignNotZero(vec2 v)
+{
+    return vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+float PackNormal(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    vec2 octahedral = n.z >= 0.0 ? n.xy : (1.0 - abs(n.yx)) * SignNotZero(n.xy);
+    ivec2 quantized = ivec2(round((octahedral * 0.5 + 0.5) * 31.0));
+    return float(quantized.x * 32 + quantized.y);
+}
+
+vec3 UnpackNormal(float packedNormal)
+{
+    int value = int(packedNormal);
+    vec2 octahedral = vec2(value / 32, value % 32) / 31.0 * 2.0 - 1.0;
+    vec3 n = vec3(octahedral, 1.0 - abs(octahedral.x) - abs(octahedral.y));
+    if (n.z < 0.0)
+        n.xy = (1.0 - abs(n.yx)) * SignNotZero(n.xy);
+    return normalize(n);
+}
+
+// Termenul scump si independent de camera: difuza luminii principale plus suma luminilor de umplere.
+vec3 Irradiance(vec3 norm)
+{
+    vec3 irradiance = MainLightDiffuse(norm);
+    for (int i = 0; i < fillLightCount; ++i)
+    {
+        vec3 toLight = fillLights[i].xyz - FragPos;
+        float distanceSquared = dot(toLight, toLight);
+        irradiance += fillLights[i].w * dV * max(dot(norm, toLight * inversesqrt(distanceSquared)), 0.0) / (1.0 + distanceSquared);
+    }
+    return irradiance;
+}
+
+void main()
+{
+    vec3 norm = normalize(Normal);
+    float viewDepth = 1.0 / gl_FragCoord.w;
+
+    // cheia: lumina cu care s-a calculat termenul si adancimea liniara
+    vec4 key = vec4(lightKey, viewDepth);
+    vec3 irradiance = vec3(0.0);
+    bool bHit = false;
+
+    if (reuseHistory && PrevClipPos.w > 0.0)
+    {
+        vec2 uv = PrevClipPos.xy / PrevClipPos.w * 0.5 + 0.5;
+        if (all(greaterThanEqual(uv, vec2(0.0))) && all(lessThan(uv, vec2(1.0))))
+        {
+            ivec2 texel = ivec2(uv * vec2(textureSize(historyKey, 0)));
+            vec4 previousKey = texelFetch(historyKey, texel, 0);
+            vec4 previousIrradiance = texelFetch(historyIrradiance, texel, 0);
+
+            // aceeasi suprafata (adancimea ei in cadrul anterior si normala) si lumina deplasata sub toleranta
+            bHit = previousKey.w > 0.0 && abs(previousKey.w - PrevClipPos.w) < depthTolerance * PrevClipPos.w &&
+                dot(UnpackNormal(previousIrradiance.a), norm) > NORMAL_TOLERANCE &&
+                length(previousKey.xyz - lightKey) < lightTolerance;
+            if (bHit)
+            {
+                irradiance = previousIrradiance.rgb;
+                // cheia ramane cea de la calcul, ca abaterea sa nu treaca de toleranta pas cu pas
+                key.xyz = previousKey.xyz;
+            }
+        }
+    }
+
+    if (!bHit)
+        irradiance = Irradiance(norm);
+
+    // ambientala si speculara sunt ieftine si depind de camera, deci se calculeaza mereu;
+    // fara lumini de umplere, culoarea e aceeasi cu Shade() din PhongShading.glsl
+    FragColor = vec4((ViewDependentLight(norm) + irradiance) * objectColor, 1.0);
+    CachedIrradiance = vec4(irradiance, PackNormal(norm));
+    CacheKey = key;
+    CacheStats = vec2(1.0, bHit ? 1.0 : 0.0);
+}
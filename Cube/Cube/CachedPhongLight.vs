@@ -0,0 +1,4 @@
+#version 330 core
+// PhongLight.vs cu pozitia din cadrul anterior (PrevClipPos), pentru CachedPhongLight.fs
+#define TEMPORAL_CACHE
+#include "PhongLight.vs"
@@ -0,0 +1,303 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <glm.hpp>
+
+#include "VoxelWorld.h"
+#include "FrameMemory.h"
+
+// Meshing-ul chunk-urilor: doar fetele care despart un voxel plin de aer, unite in
+// dreptunghiuri cat mai mari (greedy meshing). Nu depinde de OpenGL.
+
+enum EMeshingMode
+{
+	MESH_CULLED_FACES,
+	MESH_GREEDY
+};
+
+inline const char* GetMeshingModeName(EMeshingMode mode)
+{
+	switch (mode)
+	{
+	case EMeshingMode::MESH_CULLED_FACES:
+		return "culled faces";
+	case EMeshingMode::MESH_GREEDY:
+		return "greedy";
+	}
+	return "unknown";
+}
+
+// Varf compact de 8 octeti (fata de 24 pentru varfurile cubului din Cube.cpp):
+//   position: x, y, z in chunk (0..32, cate 6 biti) si fata (3 biti: 0..5 = +X, -X, +Y, -Y, +Z, -Z)
+//   material: id-ul voxelului
+// VoxelChunk.vs decodeaza formatul; fiecare quad are 4 varfuri si foloseste un index buffer comun.
+struct VoxelVertex
+{
+	uint32_t position;
+	uint32_t material;
+};
+
+inline VoxelVertex PackVoxelVertex(int x, int y, int z, int face, VoxelId id)
+{
+	VoxelVertex vertex;
+	vertex.position = (uint32_t)x | ((uint32_t)y << 6) | ((uint32_t)z << 12) | ((uint32_t)face << 18);
+	vertex.material = id;
+	return vertex;
+}
+
+// Fetele vizibile ale chunk-ului, din blocul cu margine produs de VoxelWorld::CopyPaddedChunk.
+// Fiecare chunk emite doar fetele voxelilor proprii, deci granita dintre doua chunk-uri nu se dubleaza.
+inline void MeshChunk(const std::vector<VoxelId>& padded, EMeshingMode mode, std::vector<VoxelVertex>& vertices)
+{
+	vertices.clear();
+	VoxelId mask[CHUNK_SIZE * CHUNK_SIZE];
+
+	for (int face = 0; face < 6; ++face)
+	{
+		const int axis = face / 2;
+		const int side = face % 2 == 0 ? 1 : -1;
+		// (u, v, axa) formeaza un sistem drept, deci ordinea (u0,v0) (u1,v0) (u1,v1) (u0,v1)
+		// este in sens trigonometric privita dinspre +axa
+		const int uAxis = (axis + 1) % 3;
+		const int vAxis = (axis + 2) % 3;
+
+		glm::ivec3 step(0);
+		step[axis] = side;
+		const int neighbourOffset = VoxelWorld::GetPaddedIndex(step.x, step.y, step.z) - VoxelWorld::GetPaddedIndex(0, 0, 0);
+
+		for (int layer = 0; layer < CHUNK_SIZE; ++layer)
+		{
+			// masca fetelor expuse din acest strat
+			bool bAnyFace = false;
+			glm::ivec3 voxel;
+			voxel[axis] = layer;
+			for (int v = 0; v < CHUNK_SIZE; ++v)
+			{
+				voxel[vAxis] = v;
+				for (int u = 0; u < CHUNK_SIZE; ++u)
+				{
+					voxel[uAxis] = u;
+					const int index = VoxelWorld::GetPaddedIndex(voxel.x, voxel.y, voxel.z);
+					const VoxelId id = padded[index];
+					const bool bExposed = id != VOXEL_AIR && padded[index + neighbourOffset] == VOXEL_AIR;
+					mask[v * CHUNK_SIZE + u] = bExposed ? id : VOXEL_AIR;
+					bAnyFace |= bExposed;
+				}
+			}
+			if (!bAnyFace)
+				continue;
+
+			const int plane = side > 0 ? layer + 1 : layer;
+			for (int v = 0; v < CHUNK_SIZE; ++v)
+			{
+				for (int u = 0; u < CHUNK_SIZE; )
+				{
+					const VoxelId id = mask[v * CHUNK_SIZE + u];
+					if (id == VOXEL_AIR)
+					{
+						++u;
+						continue;
+					}
+
+					// cel mai lat segment cu acelasi material, apoi cat de multe randuri il repeta
+					int width = 1, height = 1;
+					if (mode == EMeshingMode::MESH_GREEDY)
+					{
+						while (u + width < CHUNK_SIZE && mask[v * CHUNK_SIZE + u + width] == id)
+							++width;
+						for (; v + height < CHUNK_SIZE; ++height)
+						{
+							const VoxelId* pRow = &mask[(v + height) * CHUNK_SIZE + u];
+							if (std::any_of(pRow, pRow + width, [id](VoxelId other) { return other != id; }))
+								break;
+						}
+						for (int row = 0; row < height; ++row)
+							std::fill_n(&mask[(v + row) * CHUNK_SIZE + u], width, VOXEL_AIR);
+					}
+
+					glm::ivec3 corners[4];
+					const int cornerU[4] = { u, u + width, u + width, u };
+					const int cornerV[4] = { v, v, v + height, v + height };
+					for (int i = 0; i < 4; ++i)
+					{
+						corners[i][axis] = plane;
+						corners[i][uAxis] = cornerU[i];
+						corners[i][vAxis] = cornerV[i];
+					}
+
+					if (side > 0)
+					{
+						for (int i = 0; i < 4; ++i)
+							vertices.push_back(PackVoxelVertex(corners[i].x, corners[i].y, corners[i].z, face, id));
+					}
+					else
+					{
+						for (int i = 3; i >= 0; --i)
+							vertices.push_back(PackVoxelVertex(corners[i].x, corners[i].y, corners[i].z, face, id));
+					}
+					u += width;
+				}
+			}
+		}
+	}
+}
+
+struct ChunkMeshJob
+{
+	glm::ivec3 coord;
+	uint64_t revision;
+	std::vector<VoxelId> padded;
+};
+
+struct ChunkMesh
+{
+	glm::ivec3 coord;
+	uint64_t revision;
+	double meshMs;
+	std::vector<VoxelVertex> vertices;
+};
+
+// Fire de lucru pentru meshing. Firul principal copiaza chunk-urile murdare (Submit) si
+// preia mesh-urile terminate (TryPop) la fiecare cadru; incarcarea pe GPU ramane pe firul
+// principal, singurul cu context OpenGL. Copiile chunk-urilor si varfurile vin din pool-uri,
+// deci re-meshing-ul repetat nu realoca bufferele (vezi Recycle).
+class ChunkMeshWorkers
+{
+public:
+	// threadCount = 0: toate nucleele mai putin unul, pentru firul de randare
+	explicit ChunkMeshWorkers(EMeshingMode mode = EMeshingMode::MESH_GREEDY, int threadCount = 0)
+		: mode(mode)
+	{
+		if (threadCount <= 0)
+			threadCount = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+		for (int i = 0; i < threadCount; ++i)
+			threads.emplace_back(&ChunkMeshWorkers::WorkerLoop, this);
+	}
+
+	~ChunkMeshWorkers()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			bStopping = true;
+		}
+		jobReady.notify_all();
+		for (std::thread& thread : threads)
+			thread.join();
+	}
+
+	int GetThreadCount() const
+	{
+		return (int)threads.size();
+	}
+
+	// Copiaza chunk-ul din lume si il pune in coada.
+	void Submit(const VoxelWorld& world, const glm::ivec3& coord)
+	{
+		ChunkMeshJob job;
+		job.coord = coord;
+		job.revision = world.GetRevision(coord);
+		job.padded = paddedPool.Acquire();
+		world.CopyPaddedChunk(coord, job.padded);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			jobs.push_back(std::move(job));
+			++pendingCount;
+		}
+		jobReady.notify_one();
+	}
+
+	bool TryPop(ChunkMesh& mesh)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (results.empty())
+			return false;
+		mesh = std::move(results.front());
+		results.pop_front();
+		return true;
+	}
+
+	// Intoarce in pool varfurile unui mesh dupa ce au fost copiate (incarcate pe GPU).
+	void Recycle(ChunkMesh& mesh)
+	{
+		vertexPool.Release(std::move(mesh.vertices));
+	}
+
+	// Bufferele alocate pentru ca pool-urile erau goale (copii de chunk-uri si varfuri).
+	size_t GetPoolMisses()
+	{
+		return paddedPool.GetMissCount() + vertexPool.GetMissCount();
+	}
+
+	size_t GetPooledBytes()
+	{
+		return paddedPool.GetPooledBytes() + vertexPool.GetPooledBytes();
+	}
+
+	// Asteapta terminarea tuturor job-urilor trimise (folosit de benchmark si la incarcare).
+	void WaitIdle()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		allDone.wait(lock, [this]() { return pendingCount == 0; });
+	}
+
+	size_t GetPendingCount()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return pendingCount;
+	}
+
+private:
+	void WorkerLoop()
+	{
+		for (;;)
+		{
+			ChunkMeshJob job;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				jobReady.wait(lock, [this]() { return bStopping || !jobs.empty(); });
+				if (bStopping)
+					return;
+				job = std::move(jobs.front());
+				jobs.pop_front();
+			}
+
+			ChunkMesh mesh;
+			mesh.coord = job.coord;
+			mesh.revision = job.revision;
+			mesh.vertices = vertexPool.Acquire();
+			auto start = std::chrono::steady_clock::now();
+			MeshChunk(job.padded, mode, mesh.vertices);
+			mesh.meshMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			paddedPool.Release(std::move(job.padded));
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				results.push_back(std::move(mesh));
+				--pendingCount;
+			}
+			allDone.notify_all();
+		}
+	}
+
+private:
+	EMeshingMode mode;
+	std::vector<std::thread> threads;
+
+	std::mutex mutex;
+	std::condition_variable jobReady;
+	std::condition_variable allDone;
+	std::deque<ChunkMeshJob> jobs;
+	std::deque<ChunkMesh> results;
+	VectorPool<VoxelId> paddedPool;
+	VectorPool<VoxelVertex> vertexPool;
+	size_t pendingCount = 0;
+	bool bStopping = false;
+};
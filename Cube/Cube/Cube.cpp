@@ -1,13 +1,18 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <memory>
+#include <new>
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h> 
 
 #include <GL/glew.h>
-#include <GLM.hpp>
+#include <glm.hpp>
 #include <gtc/matrix_transform.hpp>
 #include <gtc/type_ptr.hpp>
 #include <glfw3.h>
@@ -15,339 +20,47 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+#include "Shader.h"
+#include "GpuCulling.h"
+#include "Transparency.h"
+#include "VoxelRenderer.h"
+#include "TemporalCache.h"
+#include "FrameMemory.h"
+#include "GpuMemory.h"
+#include "InputQueue.h"
+#include "FramePacer.h"
+#include "SimdMath.h"
+#include "Camera.h"
+#include "AssetPath.h"
+
+#ifdef _MSC_VER
 #pragma comment (lib, "glfw3dll.lib")
 #pragma comment (lib, "glew32.lib")
 #pragma comment (lib, "OpenGL32.lib")
+#endif
 
-const unsigned int SCR_WIDTH = 800;
-const unsigned int SCR_HEIGHT = 600;
-
-enum ECameraMovementType
+// Toate alocarile prin operator new trec pe aici, ca FrameMemory sa poata numara alocarile
+// facute de firul de randare intr-un cadru.
+void* operator new(std::size_t size)
 {
-	UNKNOWN,
-	FORWARD,
-	BACKWARD,
-	LEFT,
-	RIGHT,
-	UP,
-	DOWN
-};
-
-class Camera
-{
-private:
-	const float zNEAR = 0.1f;
-	const float zFAR = 500.f;
-	const float YAW = -90.0f;
-	const float PITCH = 0.0f;
-	const float FOV = 45.0f;
-	glm::vec3 startPosition;
-
-public:
-	Camera(const int width, const int height, const glm::vec3& position)
-	{
-		startPosition = position;
-		Set(width, height, position);
-	}
-
-	void Set(const int width, const int height, const glm::vec3& position)
-	{
-		this->isPerspective = true;
-		this->yaw = YAW;
-		this->pitch = PITCH;
-
-		this->FoVy = FOV;
-		this->width = width;
-		this->height = height;
-		this->zNear = zNEAR;
-		this->zFar = zFAR;
-
-		this->worldUp = glm::vec3(0, 1, 0);
-		this->position = position;
-
-		lastX = width / 2.0f;
-		lastY = height / 2.0f;
-		bFirstMouseMove = true;
-
-		UpdateCameraVectors();
-	}
-
-	void Reset(const int width, const int height)
-	{
-		Set(width, height, startPosition);
-	}
-
-	void Reshape(int windowWidth, int windowHeight)
-	{
-		width = windowWidth;
-		height = windowHeight;
-
-		glViewport(0, 0, windowWidth, windowHeight);
-	}
-
-	const glm::mat4 GetViewMatrix() const
-	{
-		return glm::lookAt(position, position + forward, up);
-	}
-
-	const glm::vec3 GetPosition() const
-	{
-		return position;
-	}
-
-	const glm::mat4 GetProjectionMatrix() const
-	{
-		glm::mat4 Proj = glm::mat4(1);
-		if (isPerspective) {
-			float aspectRatio = ((float)(width)) / height;
-			Proj = glm::perspective(glm::radians(FoVy), aspectRatio, zNear, zFar);
-		}
-		else {
-			float scaleFactor = 2000.f;
-			Proj = glm::ortho<float>(
-				-width / scaleFactor, width / scaleFactor,
-				-height / scaleFactor, height / scaleFactor, -zFar, zFar);
-		}
-		return Proj;
-	}
-
-	void ProcessKeyboard(ECameraMovementType direction, float deltaTime)
-	{
-		float velocity = (float)(cameraSpeedFactor * deltaTime);
-
-		switch (direction)
-		{
-		case ECameraMovementType::FORWARD:
-			position += forward * velocity;
-			break;
-		case ECameraMovementType::BACKWARD:
-			position -= forward * velocity;
-			break;
-		case ECameraMovementType::LEFT:
-			position -= right * velocity;
-			break;
-		case ECameraMovementType::RIGHT:
-			position += right * velocity;
-			break;
-		case ECameraMovementType::UP:
-			position += up * velocity;
-			break;
-		case ECameraMovementType::DOWN:
-			position -= up * velocity;
-			break;
-		}
-	}
-
-	void MouseControl(float xPos, float yPos)
-	{
-		if (bFirstMouseMove)
-		{
-			lastX = xPos;
-			lastY = yPos;
-			bFirstMouseMove = false;
-		}
-
-		float xChange = xPos - lastX;
-		float yChange = lastY - yPos;
-
-		lastX = xPos;
-		lastY = yPos;
-
-		if (fabs(xChange) <= 1e-6 && fabs(yChange) <= 1e-6)
-		{
-			return;
-		}
-
-		xChange *= mouseSensitivity;
-		yChange *= mouseSensitivity;
-
-		ProcessMouseMovement(xChange, yChange);
-	}
-
-	void ProcessMouseScroll(float yOffset)
-	{
-		if (FoVy >= 1.0f && FoVy <= 90.0f)
-		{
-			FoVy -= yOffset;
-		}
-		if (FoVy <= 1.0f)
-			FoVy = 1.0f;
-		if (FoVy >= 90.0f)
-			FoVy = 90.0f;
-	}
-
-private:
-	void ProcessMouseMovement(float xOffset, float yOffset, bool constrainPitch = true)
-	{
-		yaw += xOffset;
-		pitch += yOffset;
-
-		if (constrainPitch)
-		{
-			if (pitch > 89.0f)
-				pitch = 89.0f;
-			if (pitch < -89.0f)
-				pitch = -89.0f;
-		}
-
-		UpdateCameraVectors();
-	}
-
-	void UpdateCameraVectors()
-	{
-		this->forward.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
-		this->forward.y = sin(glm::radians(pitch));
-		this->forward.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
-		this->forward = glm::normalize(this->forward);
-		right = glm::normalize(glm::cross(forward, worldUp));
-		up = glm::normalize(glm::cross(right, forward));
-	}
-
-protected:
-	const float cameraSpeedFactor = 2.5f;
-	const float mouseSensitivity = 0.1f;
-
-	float zNear;
-	float zFar;
-	float FoVy;
-	int width;
-	int height;
-	bool isPerspective;
-
-	glm::vec3 position;
-	glm::vec3 forward;
-	glm::vec3 right;
-	glm::vec3 up;
-	glm::vec3 worldUp;
-
-	float yaw;
-	float pitch;
-
-	bool bFirstMouseMove = true;
-	float lastX = 0.f, lastY = 0.f;
-};
+	++ThreadHeapAllocations();
+	if (void* pMemory = malloc(size ? size : 1))
+		return pMemory;
+	throw std::bad_alloc();
+}
 
-class Shader
+void operator delete(void* pMemory) noexcept
 {
-public:
-	Shader(const char* vertexPath, const char* fragmentPath)
-	{
-		Init(vertexPath, fragmentPath);
-	}
-
-	~Shader()
-	{
-		glDeleteProgram(ID);
-	}
-
-	void Use() const
-	{
-		glUseProgram(ID);
-	}
-
-	unsigned int GetID() const
-	{
-		return ID;
-	}
-
-	unsigned int loc_model_matrix;
-	unsigned int loc_view_matrix;
-	unsigned int loc_projection_matrix;
-
-	void SetVec3(const std::string& name, const glm::vec3& value) const
-	{
-		glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
-	}
-	void SetVec3(const std::string& name, float x, float y, float z) const
-	{
-		glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
-	}
-	void SetFloat(const std::string& name, float fValue) const
-	{
-		glUniform1f(glGetUniformLocation(ID, name.c_str()), fValue);
-	}
-	void SetMat4(const std::string& name, const glm::mat4& mat) const
-	{
-		glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
-	}
-
-private:
-	void Init(const char* vertexPath, const char* fragmentPath)
-	{
-		std::string vertexCode;
-		std::string fragmentCode;
-		std::ifstream vShaderFile;
-		std::ifstream fShaderFile;
-
-		vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-		fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-		try
-		{
-			vShaderFile.open(vertexPath);
-			fShaderFile.open(fragmentPath);
-			std::stringstream vShaderStream, fShaderStream;
-			vShaderStream << vShaderFile.rdbuf();
-			fShaderStream << fShaderFile.rdbuf();
-			vShaderFile.close();
-			fShaderFile.close();
-			vertexCode = vShaderStream.str();
-			fragmentCode = fShaderStream.str();
-		}
-		catch (std::ifstream::failure e)
-		{
-			std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
-		}
-		const char* vShaderCode = vertexCode.c_str();
-		const char* fShaderCode = fragmentCode.c_str();
-
-		unsigned int vertex, fragment;
-
-		vertex = glCreateShader(GL_VERTEX_SHADER);
-		glShaderSource(vertex, 1, &vShaderCode, NULL);
-		glCompileShader(vertex);
-		CheckCompileErrors(vertex, "VERTEX");
-
-		fragment = glCreateShader(GL_FRAGMENT_SHADER);
-		glShaderSource(fragment, 1, &fShaderCode, NULL);
-		glCompileShader(fragment);
-		CheckCompileErrors(fragment, "FRAGMENT");
-
-		ID = glCreateProgram();
-		glAttachShader(ID, vertex);
-		glAttachShader(ID, fragment);
-		glLinkProgram(ID);
-		CheckCompileErrors(ID, "PROGRAM");
+	free(pMemory);
+}
 
-		glDeleteShader(vertex);
-		glDeleteShader(fragment);
-	}
+void operator delete(void* pMemory, std::size_t) noexcept
+{
+	free(pMemory);
+}
 
-	void CheckCompileErrors(unsigned int shader, std::string type)
-	{
-		GLint success;
-		GLchar infoLog[1024];
-		if (type != "PROGRAM")
-		{
-			glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-			if (!success)
-			{
-				glGetShaderInfoLog(shader, 1024, NULL, infoLog);
-				std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
-			}
-		}
-		else
-		{
-			glGetProgramiv(shader, GL_LINK_STATUS, &success);
-			if (!success)
-			{
-				glGetProgramInfoLog(shader, 1024, NULL, infoLog);
-				std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
-			}
-		}
-	}
-private:
-	unsigned int ID;
-};
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 600;
 
 GLuint ProjMatrixLocation, ViewMatrixLocation, WorldMatrixLocation;
 Camera* pCamera = nullptr;
@@ -370,7 +83,7 @@ unsigned int CreateTexture(const std::string& strTexturePath)
 
 		glGenTextures(1, &textureId);
 		glBindTexture(GL_TEXTURE_2D, textureId);
-		glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+		GpuTexImage2D(textureId, format, width, height, format, GL_UNSIGNED_BYTE, data, true);
 		glGenerateMipmap(GL_TEXTURE_2D);
 
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -386,15 +99,18 @@ unsigned int CreateTexture(const std::string& strTexturePath)
 	return textureId;
 }
 
-void Cleanup()
-{
-	delete pCamera;
-}
-
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
-void processInput(GLFWwindow* window);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+void RegisterKeyBindings(InputSystem& input, GLFWwindow* window);
+void RunCullingBenchmark(unsigned int cubeVBO, const Shader& fieldShader);
+void RunTransparencyBenchmark(unsigned int cubeVBO);
+void RunTemporalCacheBenchmark(unsigned int cubeVBO);
+void SetFieldUniforms(const Shader& shader, const glm::vec3& lightPos);
+void SetCachedLightingUniforms(const Shader& shader, const TemporalCache& cache, const glm::vec3& lightKey);
+std::vector<glm::vec4> BuildFillLights(int count);
+void PrintMemoryStats();
 
 double deltaTime = 0.0f;
 double lastFrame = 0.0f;
@@ -414,111 +130,83 @@ glm::vec3 objRotation(0.0f);
 glm::vec3 objScale(1.f);
 float radius = 0.1f;
 
-void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
-{
-	// modelarea componentei ambientale
-
-	if (key == GLFW_KEY_A && action == GLFW_PRESS)
-	{
-		if (ambientalValue < 1.0)
-			ambientalValue += 0.1;
-	}
-	if (key == GLFW_KEY_Z && action == GLFW_PRESS)
-	{
-		if (ambientalValue > 0.0)
-			ambientalValue -= 0.1;
-	}
+int fieldSize = 0;
+ECullingMode cullingMode = ECullingMode::CULL_COMPUTE;
+ETransparencyMode transparencyMode = ETransparencyMode::TRANSPARENCY_OFF;
+float fieldAlpha = 0.25f;
 
-	// modelarea componentei difuze
+int voxelWorldSize = 0;
+VoxelRenderer* pVoxelRenderer = nullptr;
 
-	if (key == GLFW_KEY_D && action == GLFW_PRESS)
-	{
-		if (diffuseValue < 1.0)
-			diffuseValue += 0.1;
-	}
-	if (key == GLFW_KEY_C && action == GLFW_PRESS)
-	{
-		if (diffuseValue > 0.0)
-			diffuseValue -= 0.1;
-	}
+TemporalCache* pTemporalCache = nullptr;
+std::vector<glm::vec4> fillLights;
 
-	// modelarea componentei speculare
-
-	if (key == GLFW_KEY_S && action == GLFW_PRESS)
-	{
-		if (specularValue < 1.0)
-			specularValue += 0.1;
-	}
-	if (key == GLFW_KEY_X && action == GLFW_PRESS)
-	{
-		if (specularValue > 0.0)
-			specularValue -= 0.1;
-	}
-
-	// exponentul de reflexie speculara
-
-	if (key == GLFW_KEY_E && action == GLFW_PRESS)
-	{
-		specularExp *= 2;
-	}
-
-	if (key == GLFW_KEY_F && action == GLFW_PRESS)
-	{
-		specularExp /= 2;
-	}
-
-	// dublarea inaltimii obiectului
-
-	if (key == GLFW_KEY_9 && action == GLFW_PRESS)
-	{
-		objHeight *= 2;
-	}
-
-	// injumatatirea inaltimii obiectului
-
-	if (key == GLFW_KEY_0 && action == GLFW_PRESS)
-	{
-		objHeight /= 2;
-	}
-
-	// marirea razei cercului
-
-	if (key == GLFW_KEY_INSERT && action == GLFW_PRESS)
-	{
-		radius += 0.05f;
-	}
-
-	// micsorarea razei cercului
-
-	if (key == GLFW_KEY_DELETE && action == GLFW_PRESS)
-	{
-		radius -= 0.05f;
-	}
-
-	if (key == GLFW_KEY_I && action == GLFW_PRESS)
-	{
-		squareAttenuation /= 0.05;
-	}
-	
-	if (key == GLFW_KEY_P && action == GLFW_PRESS)
-	{
-		squareAttenuation *= 0.05;
-	}
-}
+FrameMemory* pFrameMemory = nullptr;
 
 int main(int argc, char** argv)
 {
-	std::string strFullExeFileName = argv[0];
-	std::string strExePath;
-	const size_t last_slash_idx = strFullExeFileName.rfind('\\');
-	if (std::string::npos != last_slash_idx) {
-		strExePath = strFullExeFileName.substr(0, last_slash_idx);
+	InitAssetPaths(argv[0]);
+
+	bool bBenchCulling = false;
+	bool bBenchTransparency = false;
+	bool bBenchTemporalCache = false;
+	bool bTemporalCache = false;
+	EPacingMode pacingMode = EPacingMode::PACING_VSYNC;
+	double targetFps = 60.0;
+	int framesInFlight = 2;
+	bool bDynamicResolution = false;
+	double uncappedBudgetMs = 0.0;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string strArg = argv[i];
+		if (strArg == "--field" && i + 1 < argc)
+			fieldSize = atoi(argv[++i]);
+		else if (strArg == "--bench-culling")
+			bBenchCulling = true;
+		else if (strArg == "--bench-oit")
+			bBenchTransparency = true;
+		else if (strArg == "--transparency" && i + 1 < argc)
+		{
+			std::string strMode = argv[++i];
+			if (strMode == "sorted")
+				transparencyMode = ETransparencyMode::TRANSPARENCY_SORTED;
+			else if (strMode == "weighted")
+				transparencyMode = ETransparencyMode::TRANSPARENCY_WEIGHTED;
+			else if (strMode == "linked")
+				transparencyMode = ETransparencyMode::TRANSPARENCY_LINKED_LIST;
+		}
+		else if (strArg == "--alpha" && i + 1 < argc)
+			fieldAlpha = (float)atof(argv[++i]);
+		else if (strArg == "--voxels" && i + 1 < argc)
+			voxelWorldSize = atoi(argv[++i]);
+		else if (strArg == "--temporal-cache")
+			bTemporalCache = true;
+		else if (strArg == "--fill-lights" && i + 1 < argc)
+			fillLights = BuildFillLights(atoi(argv[++i]));
+		else if (strArg == "--bench-temporal")
+			bBenchTemporalCache = true;
+		else if (strArg == "--uncapped")
+			pacingMode = EPacingMode::PACING_UNCAPPED;
+		else if (strArg == "--fps" && i + 1 < argc)
+		{
+			pacingMode = EPacingMode::PACING_LIMITED;
+			targetFps = atof(argv[++i]);
+		}
+		else if (strArg == "--frames-in-flight" && i + 1 < argc)
+			framesInFlight = atoi(argv[++i]);
+		else if (strArg == "--dynamic-res")
+			bDynamicResolution = true;
+		else if (strArg == "--gpu-budget" && i + 1 < argc)
+			uncappedBudgetMs = atof(argv[++i]);
 	}
 
 	glfwInit();
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	// trecerea transparenta copiaza adancimea scenei si are nevoie de acelasi format (D24S8)
+	glfwWindowHint(GLFW_DEPTH_BITS, 24);
+	glfwWindowHint(GLFW_STENCIL_BITS, 8);
 
 	GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "biletfeb23", NULL, NULL);
 	if (window == NULL)
@@ -528,7 +216,11 @@ int main(int argc, char** argv)
 		return -1;
 	}
 
+	InputSystem input;
+	RegisterKeyBindings(input, window);
+
 	glfwMakeContextCurrent(window);
+	glfwSetWindowUserPointer(window, &input);
 	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 	glfwSetCursorPosCallback(window, mouse_callback);
 	glfwSetScrollCallback(window, scroll_callback);
@@ -588,7 +280,7 @@ int main(int argc, char** argv)
 	glGenVertexArrays(1, &cubeVAO);
 	glGenBuffers(1, &VBO);
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+	GpuBufferData(GL_ARRAY_BUFFER, VBO, sizeof(vertices), vertices, GL_STATIC_DRAW);
 	glBindVertexArray(cubeVAO);
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
 	glEnableVertexAttribArray(0);
@@ -604,29 +296,108 @@ int main(int argc, char** argv)
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
 	glEnableVertexAttribArray(0);
 
-	pCamera = new Camera(SCR_WIDTH, SCR_HEIGHT, glm::vec3(0.0, 0.0, 3.0));
+	std::unique_ptr<Camera> camera(new Camera(SCR_WIDTH, SCR_HEIGHT, glm::vec3(0.0, 0.0, 3.0)));
+	pCamera = camera.get();
 
 	glm::vec3 lightPos(0.0f, 0.0f, 2.0f);
 
-	Shader lightingShader("PhongLight.vs", "PhongLight.fs");
+	Shader litCubeShader("PhongLight.vs", "PhongLight.fs");
 	Shader lampShader("Lamp.vs", "Lamp.fs");
+	Shader fieldShader("CubeField.vs", "PhongLight.fs");
+	Shader voxelShader("VoxelChunk.vs", "PhongLight.fs");
 
-	unsigned int floorTexture = CreateTexture(strExePath + "\\ColoredFloor.jpg");
+	// aceleasi programe, cu iluminarea scumpa refolosita din cadrul anterior (TemporalCache.h)
+	Shader cachedLightingShader("CachedPhongLight.vs", "CachedPhongLight.fs");
+	Shader cachedFieldShader("CachedCubeField.vs", "CachedPhongLight.fs");
+	Shader cachedVoxelShader("CachedVoxelChunk.vs", "CachedPhongLight.fs");
+
+	if (bBenchCulling || bBenchTransparency || bBenchTemporalCache)
+	{
+		if (bBenchCulling)
+			RunCullingBenchmark(VBO, fieldShader);
+		if (bBenchTransparency)
+			RunTransparencyBenchmark(VBO);
+		if (bBenchTemporalCache)
+			RunTemporalCacheBenchmark(VBO);
+		pCamera = nullptr;
+		glDeleteVertexArrays(1, &cubeVAO);
+		glDeleteVertexArrays(1, &lightVAO);
+		GpuDeleteBuffers(1, &VBO);
+		glfwTerminate();
+		return 0;
+	}
+
+	std::unique_ptr<InstanceCuller> pFieldCuller;
+	std::unique_ptr<TransparencyRenderer> pTransparency;
+	if (fieldSize > 0)
+	{
+		pFieldCuller.reset(new InstanceCuller(VBO, 36, BuildCubeField(fieldSize, 2.0f)));
+		pTransparency.reset(new TransparencyRenderer());
+	}
+
+	// lume de voxeli voxelWorldSize x voxelWorldSize / 2 x voxelWorldSize, cu suprafata sub camera
+	std::unique_ptr<VoxelWorld> pVoxelWorld;
+	std::unique_ptr<VoxelRenderer> pVoxels;
+	if (voxelWorldSize > 0)
+	{
+		const int worldHeight = std::max(voxelWorldSize / 2, 1);
+		pVoxelWorld.reset(new VoxelWorld(EChunkStorage::CHUNK_PALETTE));
+		GenerateTestTerrain(*pVoxelWorld, voxelWorldSize, worldHeight, voxelWorldSize);
+		pVoxels.reset(new VoxelRenderer(*pVoxelWorld, glm::vec3(-voxelWorldSize * 0.5f, -(float)worldHeight, -voxelWorldSize * 0.5f)));
+		pVoxelRenderer = pVoxels.get();
+		std::cout << "Voxel world: " << pVoxelWorld->GetSolidCount() << " voxels in " << pVoxelWorld->GetChunkCount() << " chunks, "
+			<< pVoxelWorld->GetMemoryBytes() / 1024 << " KB" << std::endl;
+	}
+
+	std::unique_ptr<TemporalCache> pCache;
+	if (bTemporalCache)
+	{
+		pCache.reset(new TemporalCache());
+		pTemporalCache = pCache.get();
+	}
+	glm::mat4 prevModel(1.0f);
+
+	unsigned int floorTexture = CreateTexture(ResolveAssetPath("ColoredFloor.jpg"));
+
+	FramePacer pacer(pacingMode, targetFps, framesInFlight, bDynamicResolution, uncappedBudgetMs);
+
+	FrameMemory frameMemory;
+	pFrameMemory = &frameMemory;
+
+	// comutarea modului de sincronizare a cadrelor (vsync / fara limita / FPS tinta)
+
+	input.BindPress(GLFW_KEY_V, [&pacer]() { pacer.NextMode(); });
 
 	while (!glfwWindowShouldClose(window))
 	{
+		pacer.BeginFrame();
+		frameMemory.BeginFrame();
 
 		double currentFrame = glfwGetTime();
 		deltaTime = currentFrame - lastFrame;
 		lastFrame = currentFrame;
 
-		processInput(window);
+		input.ProcessFrame((float)deltaTime);
+		// tastele si redimensionarile pot crea resurse; cadrul lor nu intra in verificarea alocarilor
+		if (input.GetDispatchedActions() > 0)
+			frameMemory.ExpectAllocations();
+
+		int framebufferWidth, framebufferHeight;
+		glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+		pacer.BindSceneTarget(framebufferWidth, framebufferHeight);
 
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 		lightPos.x = radius * glm::sin(currentFrame);
 		lightPos.y = radius * glm::cos(currentFrame);
+
+		// geometria opaca iluminata se deseneaza in tintele cache-ului pana la End()
+		if (pCache)
+			pCache->Begin(pCamera->GetProjectionMatrix() * pCamera->GetViewMatrix(),
+				glm::vec4(diffuseValue, constantAttenuation, linearAttenuation, squareAttenuation));
+
+		const Shader& lightingShader = pCache ? cachedLightingShader : litCubeShader;
 		lightingShader.Use();
 		lightingShader.SetVec3("objectColor", 0.5f, 1.0f, 0.31f);
 		lightingShader.SetVec3("lightColor", 1.0f, 1.0f, 1.0f);
@@ -650,11 +421,43 @@ int main(int argc, char** argv)
 		model = glm::scale(model, glm::vec3(1.0f, objHeight, 1.0f));
 		model = glm::scale(model, objScale);
 		lightingShader.SetMat4("model", model);
+		if (pCache)
+		{
+			// rotirea sau mutarea cubului misca lumina in spatiul lui si invalideaza pixelii
+			SetCachedLightingUniforms(lightingShader, *pCache, glm::vec3(glm::inverse(model) * glm::vec4(lightPos, 1.0f)));
+			lightingShader.SetMat4("prevModel", prevModel);
+		}
+		prevModel = model;
 
 		glBindVertexArray(cubeVAO);
 		glBindBuffer(GL_ARRAY_BUFFER, VBO);
 		glDrawArrays(GL_TRIANGLES, 0, 36);
 
+		if (pFieldCuller && transparencyMode == ETransparencyMode::TRANSPARENCY_OFF)
+		{
+			pFieldCuller->Cull(cullingMode, pCamera->GetProjectionMatrix(), pCamera->GetViewMatrix(), frameMemory.GetArena());
+
+			const Shader& opaqueFieldShader = pCache ? cachedFieldShader : fieldShader;
+			SetFieldUniforms(opaqueFieldShader, lightPos);
+			if (pCache)
+				SetCachedLightingUniforms(opaqueFieldShader, *pCache, lightPos);
+			pFieldCuller->Draw();
+		}
+
+		if (pVoxels)
+		{
+			if (pVoxels->Update())
+				frameMemory.ExpectAllocations();
+			const Shader& opaqueVoxelShader = pCache ? cachedVoxelShader : voxelShader;
+			SetFieldUniforms(opaqueVoxelShader, lightPos);
+			if (pCache)
+				SetCachedLightingUniforms(opaqueVoxelShader, *pCache, lightPos);
+			pVoxels->Draw(opaqueVoxelShader, pCamera->GetProjectionMatrix(), pCamera->GetViewMatrix());
+		}
+
+		if (pCache)
+			pCache->End();
+
 		lampShader.Use();
 		lampShader.SetMat4("projection", pCamera->GetProjectionMatrix());
 		lampShader.SetMat4("view", pCamera->GetViewMatrix());
@@ -665,6 +468,21 @@ int main(int argc, char** argv)
 		glBindVertexArray(lightVAO);
 		glDrawArrays(GL_TRIANGLES, 0, 36);
 
+		// campul translucid se deseneaza dupa toata geometria opaca
+		if (pFieldCuller && transparencyMode != ETransparencyMode::TRANSPARENCY_OFF)
+		{
+			if (transparencyMode == ETransparencyMode::TRANSPARENCY_SORTED)
+				pFieldCuller->CullSorted(pCamera->GetProjectionMatrix(), pCamera->GetViewMatrix(), frameMemory.GetArena());
+			else
+				pFieldCuller->Cull(cullingMode, pCamera->GetProjectionMatrix(), pCamera->GetViewMatrix(), frameMemory.GetArena());
+
+			const Shader& transparentShader = pTransparency->Begin(transparencyMode);
+			SetFieldUniforms(transparentShader, lightPos);
+			transparentShader.SetFloat("alpha", fieldAlpha);
+			pFieldCuller->Draw();
+			pTransparency->End();
+		}
+
 		//glm::mat4 lightProjection, lightView;
 		//glm::mat4 lightSpaceMatrix;
 		//float near_plane = 1.0f, far_plane = 7.5f;
@@ -706,17 +524,47 @@ int main(int argc, char** argv)
 		//glDisable(GL_CULL_FACE);
 		//renderScene(shadowMappingShader);
 
+		pacer.ResolveSceneTarget();
+
 		glfwSwapBuffers(window);
+		input.OnFramePresented(glfwGetTime());
+		pacer.EndFrame();
 		glfwPollEvents();
+		frameMemory.EndFrame();
 	}
 
-	Cleanup();
+	pacer.PrintStats();
+
+	const LatencyStats& latency = input.GetLatencyStats();
+	std::cout << "Input-to-present latency: " << latency.samples << " frames, mean " << latency.Mean()
+		<< " ms, min " << latency.minMs << " ms, max " << latency.maxMs << " ms, dropped cursor samples " << input.GetDroppedCursorSamples()
+		<< ", dropped key/resize events " << input.GetDroppedReliableEvents() << std::endl;
+
+	if (pCache)
+	{
+		const FractionStats& hitRate = pCache->GetHitRateStats();
+		const FractionStats& coverage = pCache->GetCoverageStats();
+		std::cout << "Temporal cache: " << hitRate.stats.samples << " frames, hit rate mean " << hitRate.stats.mean * 100.0
+			<< "%, min " << hitRate.stats.minValue * 100.0 << "%, p95 " << hitRate.Percentile(0.95) * 100.0f
+			<< "%; coverage mean " << coverage.stats.mean * 100.0 << "%, min " << coverage.stats.minValue * 100.0
+			<< "%, p95 " << coverage.Percentile(0.95) * 100.0f << "%" << std::endl;
+	}
+
+	PrintMemoryStats();
+
+	pFrameMemory = nullptr;
+	pTemporalCache = nullptr;
+	pCache.reset();
+	pVoxelRenderer = nullptr;
+	pVoxels.reset();
+	pVoxelWorld.reset();
+	pTransparency.reset();
+	pFieldCuller.reset();
+	pCamera = nullptr;
 
 	glDeleteVertexArrays(1, &cubeVAO);
 	glDeleteVertexArrays(1, &lightVAO);
-	glDeleteBuffers(1, &VBO);
-
-	// delete pCamera;
+	GpuDeleteBuffers(1, &VBO);
 
 	glfwTerminate();
 	return 0;
@@ -749,7 +597,7 @@ void renderFloor()
 		glGenBuffers(1, &planeVBO);
 		glBindVertexArray(planeVAO);
 		glBindBuffer(GL_ARRAY_BUFFER, planeVBO);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(planeVertices), planeVertices, GL_STATIC_DRAW);
+		GpuBufferData(GL_ARRAY_BUFFER, planeVBO, sizeof(planeVertices), planeVertices, GL_STATIC_DRAW);
 		glEnableVertexAttribArray(0);
 		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
 		glEnableVertexAttribArray(1);
@@ -763,106 +611,446 @@ void renderFloor()
 	glDrawArrays(GL_TRIANGLES, 0, 6);
 }
 
-void processInput(GLFWwindow* window)
+// Compara culling-ul pe CPU cu cele doua cai GPU pe campuri de cuburi din ce in ce mai mari.
+// Timpul CPU acopera culling-ul si trimiterea comenzilor, timpul GPU vine din GL_TIME_ELAPSED.
+void RunCullingBenchmark(unsigned int cubeVBO, const Shader& fieldShader)
 {
-	// inchiderea aplicatiei
+	const int fieldSizes[] = { 10, 32, 64, 100 };
+	const ECullingMode modes[] = { ECullingMode::CULL_NONE, ECullingMode::CULL_CPU, ECullingMode::CULL_TRANSFORM_FEEDBACK, ECullingMode::CULL_COMPUTE };
+	const int warmupFrames = 10;
+	const int measuredFrames = 100;
 
-	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-	{
-		glfwSetWindowShouldClose(window, true);
-	}
+	Camera camera(SCR_WIDTH, SCR_HEIGHT, glm::vec3(0.0f));
+	const glm::mat4 projection = camera.GetProjectionMatrix();
+	const glm::mat4 view = camera.GetViewMatrix();
 
-	if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
-	{
-		pCamera->ProcessKeyboard(FORWARD, (float)deltaTime);
-	}
-	if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
+	unsigned int timerQuery;
+	glGenQueries(1, &timerQuery);
+	FrameArena arena;
+
+	std::cout << "instances\tmode\tvisible\tcpu_ms\tgpu_ms\tframe_ms" << std::endl;
+	for (int fieldSize : fieldSizes)
 	{
-		pCamera->ProcessKeyboard(BACKWARD, (float)deltaTime);
+		InstanceCuller culler(cubeVBO, 36, BuildCubeField(fieldSize, 2.0f));
+
+		for (ECullingMode mode : modes)
+		{
+			if (!culler.IsSupported(mode))
+			{
+				std::cout << culler.GetInstanceCount() << "\t" << GetCullingModeName(mode) << "\tunsupported" << std::endl;
+				continue;
+			}
+
+			double cpuMs = 0.0, gpuMs = 0.0, frameMs = 0.0;
+			for (int frame = 0; frame < warmupFrames + measuredFrames; ++frame)
+			{
+				glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+				glBeginQuery(GL_TIME_ELAPSED, timerQuery);
+
+				arena.Reset();
+				auto start = std::chrono::high_resolution_clock::now();
+				culler.Cull(mode, projection, view, arena);
+				fieldShader.Use();
+				fieldShader.SetMat4("projection", projection);
+				fieldShader.SetMat4("view", view);
+				culler.Draw();
+				auto submitted = std::chrono::high_resolution_clock::now();
+
+				glEndQuery(GL_TIME_ELAPSED);
+				glFinish();
+				auto finished = std::chrono::high_resolution_clock::now();
+
+				GLuint64 gpuNs = 0;
+				glGetQueryObjectui64v(timerQuery, GL_QUERY_RESULT, &gpuNs);
+
+				if (frame >= warmupFrames)
+				{
+					cpuMs += std::chrono::duration<double, std::milli>(submitted - start).count();
+					frameMs += std::chrono::duration<double, std::milli>(finished - start).count();
+					gpuMs += gpuNs / 1.0e6;
+				}
+			}
+
+			std::cout << culler.GetInstanceCount() << "\t" << GetCullingModeName(mode) << "\t" << culler.ReadVisibleCount()
+				<< "\t" << cpuMs / measuredFrames << "\t" << gpuMs / measuredFrames << "\t" << frameMs / measuredFrames << std::endl;
+		}
 	}
-	if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS)
+
+	glDeleteQueries(1, &timerQuery);
+}
+
+// Uniformele de iluminare si camera comune shaderelor campului de cuburi (opac sau transparent).
+void SetFieldUniforms(const Shader& shader, const glm::vec3& lightPos)
+{
+	shader.Use();
+	shader.SetVec3("lightColor", 1.0f, 1.0f, 1.0f);
+	shader.SetVec3("lightPos", lightPos);
+	shader.SetFloat("aV", ambientalValue);
+	shader.SetFloat("dV", diffuseValue);
+	shader.SetFloat("sV", specularValue);
+	shader.SetFloat("sE", specularExp);
+	shader.SetFloat("constantAt", constantAttenuation);
+	shader.SetFloat("linearAt", linearAttenuation);
+	shader.SetFloat("squareAt", squareAttenuation);
+	shader.SetVec3("viewPos", pCamera->GetPosition());
+	shader.SetMat4("projection", pCamera->GetProjectionMatrix());
+	shader.SetMat4("view", pCamera->GetViewMatrix());
+}
+
+// Uniformele de istoric ale cache-ului temporal si luminile de umplere (termenul scump din CachedPhongLight.fs).
+void SetCachedLightingUniforms(const Shader& shader, const TemporalCache& cache, const glm::vec3& lightKey)
+{
+	cache.Bind(shader, lightKey);
+	shader.SetInt("fillLightCount", (int)fillLights.size());
+	if (!fillLights.empty())
+		shader.SetVec4Array("fillLights", fillLights.data(), (int)fillLights.size());
+}
+
+// Lumini de umplere statice pe un cerc deasupra scenei; intensitatea totala nu depinde de numarul lor.
+std::vector<glm::vec4> BuildFillLights(int count)
+{
+	const int MAX_FILL_LIGHTS = 64;
+	count = std::min(std::max(count, 0), MAX_FILL_LIGHTS);
+
+	std::vector<glm::vec4> lights;
+	for (int i = 0; i < count; ++i)
 	{
-		pCamera->ProcessKeyboard(LEFT, (float)deltaTime);
+		const float angle = glm::radians(360.0f * i / count);
+		lights.push_back(glm::vec4(8.0f * glm::cos(angle), 6.0f, 8.0f * glm::sin(angle), 40.0f / count));
 	}
-	if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS)
+	return lights;
+}
+
+// Arena cadrului, alocarile din cadrele stabile, pool-urile de meshing si memoria video.
+void PrintMemoryStats()
+{
+	if (pFrameMemory)
+		pFrameMemory->PrintStats();
+	if (pVoxelRenderer)
 	{
-		pCamera->ProcessKeyboard(RIGHT, (float)deltaTime);
+		std::cout << "Voxel mesh pools: " << pVoxelRenderer->GetPooledBytes() / 1024 << " KB pooled, "
+			<< pVoxelRenderer->GetPoolMisses() << " buffers allocated" << std::endl;
 	}
-	if (glfwGetKey(window, GLFW_KEY_PAGE_UP) == GLFW_PRESS)
+	GetGpuMemoryTracker().PrintStats();
+}
+
+// Costul GPU al trecerii opace iluminate cu si fara cache temporal, pentru un numar crescator de
+// lumini de umplere, cu camera fixa (lumina principala orbiteaza ca in bucla principala) si cu
+// camera in miscare. hit_* = distributia pe cadre a fractiunii pixelilor acoperiti care au refolosit
+// istoricul, coverage_mean = fractiunea medie a ecranului acoperita de geometrie.
+void RunTemporalCacheBenchmark(unsigned int cubeVBO)
+{
+	const int fillLightCounts[] = { 0, 16, 64 };
+	const int warmupFrames = 10;
+	const int measuredFrames = 200;
+	const float frameTime = 1.0f / 60.0f;
+	const int fieldSize = 32;
+	const float spacing = 2.0f;
+
+	InstanceCuller culler(cubeVBO, 36, BuildCubeField(fieldSize, spacing));
+	FrameArena arena;
+	culler.Cull(ECullingMode::CULL_NONE, glm::mat4(1.0f), glm::mat4(1.0f), arena);
+	Shader cachedFieldShader("CachedCubeField.vs", "CachedPhongLight.fs");
+	TemporalCache cache;
+
+	unsigned int timerQuery;
+	glGenQueries(1, &timerQuery);
+
+	const std::vector<glm::vec4> savedFillLights = fillLights;
+	const float halfExtent = (fieldSize - 1) * spacing * 0.5f;
+
+	std::cout << "fill_lights\tcamera\tcache\tgpu_ms\thit_mean\thit_min\thit_p95\tcoverage_mean" << std::endl;
+	for (int fillLightCount : fillLightCounts)
 	{
-		pCamera->ProcessKeyboard(UP, (float)deltaTime);
+		fillLights = BuildFillLights(fillLightCount);
+		for (int bMovingCamera = 0; bMovingCamera <= 1; ++bMovingCamera)
+		{
+			for (int bCacheEnabled = 0; bCacheEnabled <= 1; ++bCacheEnabled)
+			{
+				Camera camera(SCR_WIDTH, SCR_HEIGHT, glm::vec3(0.0f, 0.0f, halfExtent + 20.0f));
+				cache.SetEnabled(bCacheEnabled != 0);
+
+				double gpuMs = 0.0;
+				for (int frame = 0; frame < warmupFrames + measuredFrames; ++frame)
+				{
+					const float time = frame * frameTime;
+					if (bMovingCamera)
+					{
+						camera.ProcessKeyboard(FORWARD, frameTime);
+						camera.MouseControl(SCR_WIDTH * 0.5f + 100.0f * glm::sin(time), SCR_HEIGHT * 0.5f);
+					}
+					const glm::vec3 lightPos(radius * glm::sin(time), radius * glm::cos(time), halfExtent + 2.0f);
+
+					glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+					glBeginQuery(GL_TIME_ELAPSED, timerQuery);
+
+					cache.Begin(camera.GetProjectionMatrix() * camera.GetViewMatrix(), glm::vec4(diffuseValue, constantAttenuation, linearAttenuation, squareAttenuation));
+					cachedFieldShader.Use();
+					cachedFieldShader.SetVec3("lightColor", 1.0f, 1.0f, 1.0f);
+					cachedFieldShader.SetVec3("lightPos", lightPos);
+					cachedFieldShader.SetVec3("viewPos", camera.GetPosition());
+					cachedFieldShader.SetMat4("projection", camera.GetProjectionMatrix());
+					cachedFieldShader.SetMat4("view", camera.GetViewMatrix());
+					SetCachedLightingUniforms(cachedFieldShader, cache, lightPos);
+					culler.Draw();
+					cache.End();
+
+					glEndQuery(GL_TIME_ELAPSED);
+					GLuint64 gpuNs = 0;
+					glGetQueryObjectui64v(timerQuery, GL_QUERY_RESULT, &gpuNs);
+
+					if (frame == warmupFrames)
+						cache.ResetStats();
+					if (frame >= warmupFrames)
+						gpuMs += gpuNs / 1.0e6;
+				}
+
+				const FractionStats& hitRate = cache.GetHitRateStats();
+				std::cout << fillLightCount << "\t" << (bMovingCamera ? "moving" : "static") << "\t" << (bCacheEnabled ? "on" : "off")
+					<< "\t" << gpuMs / measuredFrames << "\t" << hitRate.stats.mean << "\t" << hitRate.stats.minValue
+					<< "\t" << hitRate.Percentile(0.95) << "\t" << cache.GetCoverageStats().stats.mean << std::endl;
+			}
+		}
 	}
-	if (glfwGetKey(window, GLFW_KEY_PAGE_DOWN) == GLFW_PRESS)
+
+	fillLights = savedFillLights;
+	glDeleteQueries(1, &timerQuery);
+}
+
+// Compara transparenta sortata pe CPU (culling + sortare + upload la fiecare cadru) cu cele doua
+// cai OIT, la campuri din ce in ce mai mari privite din fata. "dropped" = fragmente care nu au
+// mai incaput in bufferul de noduri al listelor inlantuite, "truncated" = fragmente de dupa
+// primele 32 de straturi ale unui pixel, lasate afara la compunere.
+void RunTransparencyBenchmark(unsigned int cubeVBO)
+{
+	const int fieldSizes[] = { 20, 40, 64, 100 };
+	const ETransparencyMode modes[] = { ETransparencyMode::TRANSPARENCY_SORTED, ETransparencyMode::TRANSPARENCY_WEIGHTED, ETransparencyMode::TRANSPARENCY_LINKED_LIST };
+	const int warmupFrames = 10;
+	const int measuredFrames = 100;
+	const float spacing = 2.0f;
+
+	TransparencyRenderer transparency;
+	unsigned int timerQuery;
+	glGenQueries(1, &timerQuery);
+	FrameArena arena;
+
+	std::cout << "instances\tmode\tvisible\tcpu_ms\tgpu_ms\tframe_ms\tdropped\ttruncated" << std::endl;
+	for (int fieldSize : fieldSizes)
 	{
-		pCamera->ProcessKeyboard(DOWN, (float)deltaTime);
+		InstanceCuller culler(cubeVBO, 36, BuildCubeField(fieldSize, spacing));
+		const ECullingMode gpuCulling = culler.IsSupported(ECullingMode::CULL_COMPUTE) ? ECullingMode::CULL_COMPUTE : ECullingMode::CULL_TRANSFORM_FEEDBACK;
+
+		// camera in fata campului, cu tot campul in imagine
+		const float halfExtent = (fieldSize - 1) * spacing * 0.5f;
+		Camera camera(SCR_WIDTH, SCR_HEIGHT, glm::vec3(0.0f, 0.0f, halfExtent * 3.0f + 5.0f));
+		const glm::mat4 projection = camera.GetProjectionMatrix();
+		const glm::mat4 view = camera.GetViewMatrix();
+
+		for (ETransparencyMode mode : modes)
+		{
+			if (!transparency.IsSupported(mode))
+			{
+				std::cout << culler.GetInstanceCount() << "\t" << GetTransparencyModeName(mode) << "\tunsupported" << std::endl;
+				continue;
+			}
+
+			double cpuMs = 0.0, gpuMs = 0.0, frameMs = 0.0;
+			for (int frame = 0; frame < warmupFrames + measuredFrames; ++frame)
+			{
+				glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+				glBeginQuery(GL_TIME_ELAPSED, timerQuery);
+
+				arena.Reset();
+				auto start = std::chrono::high_resolution_clock::now();
+				if (mode == ETransparencyMode::TRANSPARENCY_SORTED)
+					culler.CullSorted(projection, view, arena);
+				else
+					culler.Cull(gpuCulling, projection, view, arena);
+
+				const Shader& shader = transparency.Begin(mode);
+				shader.SetVec3("lightColor", 1.0f, 1.0f, 1.0f);
+				shader.SetVec3("lightPos", glm::vec3(0.0f, 0.0f, halfExtent + 2.0f));
+				shader.SetVec3("viewPos", camera.GetPosition());
+				shader.SetMat4("projection", projection);
+				shader.SetMat4("view", view);
+				shader.SetFloat("alpha", fieldAlpha);
+				culler.Draw();
+				transparency.End();
+				auto submitted = std::chrono::high_resolution_clock::now();
+
+				glEndQuery(GL_TIME_ELAPSED);
+				glFinish();
+				auto finished = std::chrono::high_resolution_clock::now();
+
+				GLuint64 gpuNs = 0;
+				glGetQueryObjectui64v(timerQuery, GL_QUERY_RESULT, &gpuNs);
+
+				if (frame >= warmupFrames)
+				{
+					cpuMs += std::chrono::duration<double, std::milli>(submitted - start).count();
+					frameMs += std::chrono::duration<double, std::milli>(finished - start).count();
+					gpuMs += gpuNs / 1.0e6;
+				}
+			}
+
+			const bool bLinkedList = mode == ETransparencyMode::TRANSPARENCY_LINKED_LIST;
+			const unsigned int dropped = bLinkedList ? transparency.ReadDroppedFragments() : 0;
+			const unsigned int truncated = bLinkedList ? transparency.ReadTruncatedFragments() : 0;
+			std::cout << culler.GetInstanceCount() << "\t" << GetTransparencyModeName(mode) << "\t" << culler.ReadVisibleCount()
+				<< "\t" << cpuMs / measuredFrames << "\t" << gpuMs / measuredFrames << "\t" << frameMs / measuredFrames
+				<< "\t" << dropped << "\t" << truncated << std::endl;
+		}
 	}
 
+	glDeleteQueries(1, &timerQuery);
+}
+
+void RegisterKeyBindings(InputSystem& input, GLFWwindow* window)
+{
+	// inchiderea aplicatiei
+
+	input.BindHeld(GLFW_KEY_ESCAPE, [window](float) { glfwSetWindowShouldClose(window, true); });
+
+	input.BindHeld(GLFW_KEY_UP, [](float dt) { pCamera->ProcessKeyboard(FORWARD, dt); });
+	input.BindHeld(GLFW_KEY_DOWN, [](float dt) { pCamera->ProcessKeyboard(BACKWARD, dt); });
+	input.BindHeld(GLFW_KEY_LEFT, [](float dt) { pCamera->ProcessKeyboard(LEFT, dt); });
+	input.BindHeld(GLFW_KEY_RIGHT, [](float dt) { pCamera->ProcessKeyboard(RIGHT, dt); });
+	input.BindHeld(GLFW_KEY_PAGE_UP, [](float dt) { pCamera->ProcessKeyboard(UP, dt); });
+	input.BindHeld(GLFW_KEY_PAGE_DOWN, [](float dt) { pCamera->ProcessKeyboard(DOWN, dt); });
+
 	// reset inapoi la fereastra initiala a camerei
 
-	if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS)
+	input.BindHeld(GLFW_KEY_R, [window](float)
 	{
 		int width, height;
 		glfwGetWindowSize(window, &width, &height);
 		pCamera->Reset(width, height);
 		objMovement = glm::vec3(0.0f, 0.01, 0.003f);
-	}
+	});
 
 	// rotatie in jurul axei OX a obiectului
 
-	if (glfwGetKey(window, GLFW_KEY_3) == GLFW_PRESS)
-	{
-		objRotation += glm::vec3(.0f, -0.03f, 0.f);
-	}
-	if (glfwGetKey(window, GLFW_KEY_4) == GLFW_PRESS)
-	{
-		objRotation += glm::vec3(.0f, 0.03f, 0.f);
-	}
+	input.BindHeld(GLFW_KEY_3, [](float) { objRotation += glm::vec3(.0f, -0.03f, 0.f); });
+	input.BindHeld(GLFW_KEY_4, [](float) { objRotation += glm::vec3(.0f, 0.03f, 0.f); });
 
 	// rotatie in jurul axei OY a obiectului
 
-	if (glfwGetKey(window, GLFW_KEY_1) == GLFW_PRESS)
-	{
-		objRotation += glm::vec3(-.03f, 0.f, 0.f);
-	}
-	if (glfwGetKey(window, GLFW_KEY_2) == GLFW_PRESS)
-	{
-		objRotation += glm::vec3(.03f, 0.f, 0.f);
-	}
+	input.BindHeld(GLFW_KEY_1, [](float) { objRotation += glm::vec3(-.03f, 0.f, 0.f); });
+	input.BindHeld(GLFW_KEY_2, [](float) { objRotation += glm::vec3(.03f, 0.f, 0.f); });
 
 	// rotatie in jurul axei OZ a obiectului
 
-	if (glfwGetKey(window, GLFW_KEY_5) == GLFW_PRESS)
+	input.BindHeld(GLFW_KEY_5, [](float) { objRotation += glm::vec3(.0f, 0.f, -0.03f); });
+	input.BindHeld(GLFW_KEY_6, [](float) { objRotation += glm::vec3(.0f, 0.f, 0.03f); });
+
+	// scale fata de centrul de greutate al obietului
+
+	input.BindHeld(GLFW_KEY_7, [](float) { objScale *= glm::vec3(0.999f); });
+	input.BindHeld(GLFW_KEY_8, [](float) { objScale *= glm::vec3(1.001f); });
+
+	// modelarea componentei ambientale
+
+	input.BindPress(GLFW_KEY_A, []() { if (ambientalValue < 1.0) ambientalValue += 0.1; });
+	input.BindPress(GLFW_KEY_Z, []() { if (ambientalValue > 0.0) ambientalValue -= 0.1; });
+
+	// modelarea componentei difuze
+
+	input.BindPress(GLFW_KEY_D, []() { if (diffuseValue < 1.0) diffuseValue += 0.1; });
+	input.BindPress(GLFW_KEY_C, []() { if (diffuseValue > 0.0) diffuseValue -= 0.1; });
+
+	// modelarea componentei speculare
+
+	input.BindPress(GLFW_KEY_S, []() { if (specularValue < 1.0) specularValue += 0.1; });
+	input.BindPress(GLFW_KEY_X, []() { if (specularValue > 0.0) specularValue -= 0.1; });
+
+	// exponentul de reflexie speculara
+
+	input.BindPress(GLFW_KEY_E, []() { specularExp *= 2; });
+	input.BindPress(GLFW_KEY_F, []() { specularExp /= 2; });
+
+	// dublarea / injumatatirea inaltimii obiectului
+
+	input.BindPress(GLFW_KEY_9, []() { objHeight *= 2; });
+	input.BindPress(GLFW_KEY_0, []() { objHeight /= 2; });
+
+	// marirea / micsorarea razei cercului
+
+	input.BindPress(GLFW_KEY_INSERT, []() { radius += 0.05f; });
+	input.BindPress(GLFW_KEY_DELETE, []() { radius -= 0.05f; });
+
+	input.BindPress(GLFW_KEY_I, []() { squareAttenuation /= 0.05; });
+	input.BindPress(GLFW_KEY_P, []() { squareAttenuation *= 0.05; });
+
+	// comutarea modului de culling pentru campul de cuburi
+
+	input.BindPress(GLFW_KEY_G, []()
 	{
-		objRotation += glm::vec3(.0f, 0.f, -0.03f);
-	}
-	if (glfwGetKey(window, GLFW_KEY_6) == GLFW_PRESS)
+		cullingMode = (ECullingMode)((cullingMode + 1) % (ECullingMode::CULL_COMPUTE + 1));
+		std::cout << "Culling: " << GetCullingModeName(cullingMode) << std::endl;
+	});
+
+	// comutarea modului de transparenta pentru campul de cuburi
+
+	input.BindPress(GLFW_KEY_T, []()
 	{
-		objRotation += glm::vec3(.0f, 0.f, 0.03f);
-	}
+		transparencyMode = (ETransparencyMode)((transparencyMode + 1) % (ETransparencyMode::TRANSPARENCY_LINKED_LIST + 1));
+		std::cout << "Transparency: " << GetTransparencyModeName(transparencyMode) << std::endl;
+	});
 
-	// scale fata de centrul de greutate al obietului
+	// adaugarea / stergerea voxelului din fata camerei; se re-mesheaza doar chunk-urile atinse
 
-	if (glfwGetKey(window, GLFW_KEY_7) == GLFW_PRESS)
+	input.BindPress(GLFW_KEY_M, []()
 	{
-		objScale *= glm::vec3(0.999f);
-	}
-	if (glfwGetKey(window, GLFW_KEY_8) == GLFW_PRESS)
+		if (!pVoxelRenderer)
+			return;
+		const glm::ivec3 voxel = pVoxelRenderer->GetVoxelAt(pCamera->GetPosition() + pCamera->GetForward() * 4.0f);
+		VoxelWorld& world = pVoxelRenderer->GetWorld();
+		world.SetVoxel(voxel, world.GetVoxel(voxel) == VOXEL_AIR ? 1 : VOXEL_AIR);
+	});
+
+	// refolosirea iluminarii din cadrul anterior, pornita / oprita (cu --temporal-cache)
+
+	input.BindPress(GLFW_KEY_H, []()
 	{
-		objScale *= glm::vec3(1.001f);
-	}
+		if (!pTemporalCache)
+			return;
+		pTemporalCache->SetEnabled(!pTemporalCache->IsEnabled());
+		std::cout << "Temporal cache reuse: " << (pTemporalCache->IsEnabled() ? "on" : "off") << std::endl;
+	});
+
+	// memoria: arena cadrului, alocarile pe heap din cadrele stabile si memoria video
+
+	input.BindPress(GLFW_KEY_K, []() { PrintMemoryStats(); });
+
+	// actualizarile camerei se fac o singura data pe cadru, cu ultima pozitie a cursorului
+
+	input.onResize = [](int width, int height)
+	{
+		glViewport(0, 0, width, height);
+		pCamera->Reshape(width, height);
+	};
+	input.onCursor = [](float xPos, float yPos) { pCamera->MouseControl(xPos, yPos); };
+	input.onScroll = [](float yOffset) { pCamera->ProcessMouseScroll(yOffset); };
+}
+
+// callback-urile doar pun evenimentele in coada; procesarea are loc in bucla de randare
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+	static_cast<InputSystem*>(glfwGetWindowUserPointer(window))->PushKey(key, action, glfwGetTime());
 }
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
-	pCamera->Reshape(width, height);
+	static_cast<InputSystem*>(glfwGetWindowUserPointer(window))->PushResize(width, height, glfwGetTime());
 }
 
 void mouse_callback(GLFWwindow* window, double xpos, double ypos)
 {
-	pCamera->MouseControl((float)xpos, (float)ypos);
+	static_cast<InputSystem*>(glfwGetWindowUserPointer(window))->PushCursor(xpos, ypos, glfwGetTime());
 }
 
 void scroll_callback(GLFWwindow* window, double xoffset, double yOffset)
 {
-	pCamera->ProcessMouseScroll((float)yOffset);
-}
+	static_cast<InputSystem*>(glfwGetWindowUserPointer(window))->PushScroll(xoffset, yOffset, glfwGetTime());
+}
\ No newline at end of file
@@ -0,0 +1,312 @@
+// cube_bench: ruleaza fara fereastra partea de CPU a unui cadru din Cube.cpp (camera,
+// matricea cubului, culling-ul campului de cuburi in arena cadrului) si raporteaza
+// timpii pe cadru pentru configuratia de build cu care a fost compilat.
+//
+// Rezultatele se pot adauga intr-un fisier CSV (--record), iar --compare afiseaza
+// comparatia intre configuratii (Debug / Release / PGO); vezi bench_configs.sh.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <glm.hpp>
+#include <gtc/matrix_transform.hpp>
+
+#include "Camera.h"
+#include "CubeField.h"
+#include "FrameMemory.h"
+#include "SimdMath.h"
+
+#ifndef CUBE_BUILD_LABEL
+#define CUBE_BUILD_LABEL "unknown"
+#endif
+
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 600;
+
+struct FrameTimeStats
+{
+	double mean = 0.0;
+	double p50 = 0.0;
+	double p95 = 0.0;
+	double p99 = 0.0;
+	double max = 0.0;
+};
+
+struct BenchResult
+{
+	std::string label;
+	int fieldSize = 0;
+	int frames = 0;
+	FrameTimeStats stats;
+};
+
+FrameTimeStats ComputeStats(std::vector<double> frameMs)
+{
+	FrameTimeStats stats;
+	if (frameMs.empty())
+		return stats;
+
+	std::sort(frameMs.begin(), frameMs.end());
+	for (double ms : frameMs)
+		stats.mean += ms;
+	stats.mean /= frameMs.size();
+
+	auto percentile = [&frameMs](double p) { return frameMs[(size_t)(p * (frameMs.size() - 1) + 0.5)]; };
+	stats.p50 = percentile(0.50);
+	stats.p95 = percentile(0.95);
+	stats.p99 = percentile(0.99);
+	stats.max = frameMs.back();
+	return stats;
+}
+
+// Partea de CPU a buclei principale din Cube.cpp, fara apelurile OpenGL: aceeasi camera, aceeasi
+// matrice a cubului central si aceleasi functii de culling ca InstanceCuller (CULL_CPU, sau
+// CullSorted pentru transparenta sortata), cu lista vizibila luata din arena cadrului.
+// cameraPath schimba traseul camerei, ca profilul PGO sa poata fi antrenat pe alt scenariu decat cel masurat.
+class BenchScene
+{
+public:
+	BenchScene(int fieldSize, int cameraPath, bool bSorted)
+		: camera(SCR_WIDTH, SCR_HEIGHT, glm::vec3(0.0f, 0.0f, 3.0f)), instances(BuildCubeField(fieldSize, 2.0f)), bSorted(bSorted)
+	{
+		pathPhase = cameraPath * 1.7f;
+		pathPeriod = 120 + cameraPath * 37;
+	}
+
+	size_t GetInstanceCount() const
+	{
+		return instances.size();
+	}
+
+	unsigned int GetVisibleCount() const
+	{
+		return visibleCount;
+	}
+
+	// Intoarce o suma de control, ca sa nu poata fi eliminate calculele de compilator.
+	float RunFrame(int frame, float deltaTime)
+	{
+		const float time = frame * deltaTime;
+		arena.Reset();
+
+		// camera se deplaseaza inainte / inapoi si se roteste, ca la tinerea apasata a sagetilor
+		camera.ProcessKeyboard((frame / pathPeriod) % 2 == 0 ? BACKWARD : FORWARD, deltaTime);
+		camera.MouseControl(SCR_WIDTH * 0.5f + 200.0f * std::sin(time * 0.5f + pathPhase), SCR_HEIGHT * 0.5f + 50.0f * std::cos(time * 0.3f + pathPhase));
+
+		const glm::mat4 projection = camera.GetProjectionMatrix();
+		const glm::mat4 view = camera.GetViewMatrix();
+
+		// lumina si cubul central, ca in bucla din Cube.cpp (rotatia ca la tinerea apasata a tastelor 1-6)
+		const glm::vec3 lightPos(LIGHT_RADIUS * glm::sin(time), LIGHT_RADIUS * glm::cos(time), 2.0f);
+		const glm::vec3 rotation = glm::vec3(30.0f, 45.0f, 60.0f) * time;
+		glm::mat4 model = glm::scale(glm::mat4(1.0), glm::vec3(3.0f));
+		model = glm::rotate(model, glm::radians(rotation.x), glm::vec3(1.f, 0.f, 0.f));
+		model = glm::rotate(model, glm::radians(rotation.y), glm::vec3(0.f, 1.f, 0.f));
+		model = glm::rotate(model, glm::radians(rotation.z), glm::vec3(0.f, 0.f, 1.f));
+		const glm::vec3 modelLightPos(glm::inverse(model) * glm::vec4(lightPos, 1.0f));
+
+		// InstanceCuller::Cull / CullSorted fara incarcarea in bufferul GPU
+		glm::vec4 planes[6];
+		ExtractFrustumPlanes(projection * view, planes);
+		const unsigned int instanceCount = (unsigned int)instances.size();
+		glm::vec4* pVisible = arena.AllocateArray<glm::vec4>(instanceCount);
+		if (bSorted)
+			visibleCount = CullInstancesSorted(instances.data(), instanceCount, planes, view, arena, pVisible);
+		else
+			visibleCount = CullInstances(instances.data(), instanceCount, planes, pVisible);
+
+		float checksum = modelLightPos.x + (float)visibleCount;
+		if (visibleCount > 0)
+			checksum += pVisible[0].x;
+		return checksum;
+	}
+
+private:
+	static constexpr float LIGHT_RADIUS = 0.1f;
+
+	Camera camera;
+	std::vector<glm::vec4> instances;
+	FrameArena arena;
+	bool bSorted;
+	float pathPhase;
+	int pathPeriod;
+	unsigned int visibleCount = 0;
+};
+
+BenchResult RunBenchmark(const std::string& strLabel, int fieldSize, int cameraPath, bool bSorted, int warmupFrames, int measuredFrames)
+{
+	BenchScene scene(fieldSize, cameraPath, bSorted);
+	const float deltaTime = 1.0f / 60.0f;
+
+	std::vector<double> frameMs;
+	frameMs.reserve(measuredFrames);
+
+	double visibleSum = 0.0;
+	float checksum = 0.0f;
+	for (int frame = 0; frame < warmupFrames + measuredFrames; ++frame)
+	{
+		auto start = std::chrono::steady_clock::now();
+		checksum += scene.RunFrame(frame, deltaTime);
+		auto end = std::chrono::steady_clock::now();
+
+		if (frame >= warmupFrames)
+		{
+			frameMs.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+			visibleSum += scene.GetVisibleCount();
+		}
+	}
+
+	BenchResult result;
+	result.label = strLabel;
+	result.fieldSize = fieldSize;
+	result.frames = measuredFrames;
+	result.stats = ComputeStats(frameMs);
+
+	std::cout << "cube_bench [" << strLabel << "] field " << fieldSize << "^3 (" << scene.GetInstanceCount() << " instances), "
+		<< (bSorted ? "sorted " : "") << "camera path " << cameraPath << ", " << measuredFrames << " frames, SIMD " << simd::GetLevelName(simd::GetLevel()) << std::endl;
+	std::cout << std::fixed << std::setprecision(3)
+		<< "frame_ms  mean " << result.stats.mean << "  p50 " << result.stats.p50 << "  p95 " << result.stats.p95
+		<< "  p99 " << result.stats.p99 << "  max " << result.stats.max
+		<< "  (visible avg " << (size_t)(visibleSum / std::max(measuredFrames, 1)) << ", checksum " << checksum << ")" << std::endl;
+	return result;
+}
+
+void RecordResult(const std::string& strPath, const BenchResult& result)
+{
+	std::ofstream file(strPath, std::ios::app);
+	if (!file)
+	{
+		std::cout << "Failed to open results file: " << strPath << std::endl;
+		return;
+	}
+	file << result.label << "," << result.fieldSize << "," << result.frames << "," << result.stats.mean << ","
+		<< result.stats.p50 << "," << result.stats.p95 << "," << result.stats.p99 << "," << result.stats.max << std::endl;
+}
+
+std::vector<BenchResult> LoadResults(const std::string& strPath)
+{
+	std::vector<BenchResult> results;
+	std::ifstream file(strPath);
+	std::string strLine;
+	while (std::getline(file, strLine))
+	{
+		std::istringstream line(strLine);
+		BenchResult result;
+		std::string strField;
+		if (!std::getline(line, result.label, ','))
+			continue;
+
+		double values[7];
+		int count = 0;
+		while (count < 7 && std::getline(line, strField, ','))
+			values[count++] = atof(strField.c_str());
+		if (count < 7)
+			continue;
+
+		result.fieldSize = (int)values[0];
+		result.frames = (int)values[1];
+		result.stats.mean = values[2];
+		result.stats.p50 = values[3];
+		result.stats.p95 = values[4];
+		result.stats.p99 = values[5];
+		result.stats.max = values[6];
+
+		// pentru o configuratie rulata de mai multe ori se pastreaza ultima rulare
+		auto existing = std::find_if(results.begin(), results.end(), [&result](const BenchResult& other) { return other.label == result.label; });
+		if (existing != results.end())
+			*existing = result;
+		else
+			results.push_back(result);
+	}
+	return results;
+}
+
+// Tabel cu timpii fiecarei configuratii si accelerarea fata de Debug (sau fata de prima linie).
+int CompareResults(const std::string& strPath)
+{
+	const std::vector<BenchResult> results = LoadResults(strPath);
+	if (results.empty())
+	{
+		std::cout << "No results in " << strPath << std::endl;
+		return 1;
+	}
+
+	const BenchResult* pBaseline = &results.front();
+	for (const BenchResult& result : results)
+	{
+		if (result.label.compare(0, 5, "Debug") == 0)
+		{
+			pBaseline = &result;
+			break;
+		}
+	}
+
+	std::cout << "config\tmean_ms\tp50_ms\tp95_ms\tp99_ms\tspeedup_vs_" << pBaseline->label << std::endl;
+	std::cout << std::fixed << std::setprecision(3);
+	for (const BenchResult& result : results)
+	{
+		std::cout << result.label << "\t" << result.stats.mean << "\t" << result.stats.p50 << "\t" << result.stats.p95
+			<< "\t" << result.stats.p99 << "\t" << pBaseline->stats.mean / result.stats.mean << "x" << std::endl;
+		if (result.fieldSize != pBaseline->fieldSize)
+			std::cout << "  (warning: field " << result.fieldSize << "^3 differs from baseline " << pBaseline->fieldSize << "^3)" << std::endl;
+	}
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	std::string strLabel = CUBE_BUILD_LABEL;
+	std::string strRecordPath, strComparePath;
+	int fieldSize = 64;
+	int cameraPath = 0;
+	bool bSorted = false;
+	int warmupFrames = 60;
+	int measuredFrames = 600;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string strArg = argv[i];
+		if (strArg == "--field" && i + 1 < argc)
+			fieldSize = atoi(argv[++i]);
+		else if (strArg == "--camera-path" && i + 1 < argc)
+			cameraPath = atoi(argv[++i]);
+		else if (strArg == "--sorted")
+			bSorted = true;
+		else if (strArg == "--frames" && i + 1 < argc)
+			measuredFrames = atoi(argv[++i]);
+		else if (strArg == "--warmup" && i + 1 < argc)
+			warmupFrames = atoi(argv[++i]);
+		else if (strArg == "--label" && i + 1 < argc)
+			strLabel = argv[++i];
+		else if (strArg == "--record" && i + 1 < argc)
+			strRecordPath = argv[++i];
+		else if (strArg == "--compare" && i + 1 < argc)
+			strComparePath = argv[++i];
+		else
+		{
+			std::cout << "usage: cube_bench [--field N] [--camera-path N] [--sorted] [--frames N] [--warmup N] [--label NAME] [--record FILE.csv] [--compare FILE.csv]" << std::endl;
+			return 1;
+		}
+	}
+
+	if (!strComparePath.empty())
+		return CompareResults(strComparePath);
+
+	if (fieldSize <= 0 || measuredFrames <= 0)
+	{
+		std::cout << "--field and --frames must be positive" << std::endl;
+		return 1;
+	}
+
+	const BenchResult result = RunBenchmark(strLabel, fieldSize, cameraPath, bSorted, warmupFrames, measuredFrames);
+	if (!strRecordPath.empty())
+		RecordResult(strRecordPath, result);
+	return 0;
+}
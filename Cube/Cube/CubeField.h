@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <glm.hpp>
+
+#include "FrameMemory.h"
+
+// Campul de cuburi instantiate si testul de vizibilitate facut pe CPU.
+// Nu depinde de OpenGL, asa ca poate fi folosit si de cube_bench.
+
+// Cuburi de latura 1 asezate intr-o grila fieldSize^3 centrata in origine.
+inline std::vector<glm::vec4> BuildCubeField(int fieldSize, float spacing)
+{
+	std::vector<glm::vec4> instances;
+	instances.reserve((size_t)fieldSize * fieldSize * fieldSize);
+
+	const float offset = (fieldSize - 1) * spacing * 0.5f;
+	for (int x = 0; x < fieldSize; ++x)
+	{
+		for (int y = 0; y < fieldSize; ++y)
+		{
+			for (int z = 0; z < fieldSize; ++z)
+			{
+				instances.push_back(glm::vec4(x * spacing - offset, y * spacing - offset, z * spacing - offset, 1.0f));
+			}
+		}
+	}
+	return instances;
+}
+
+// Planurile frustumului (normala spre interior, normalizate) extrase din projection * view.
+inline void ExtractFrustumPlanes(const glm::mat4& viewProjection, glm::vec4 planes[6])
+{
+	glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+	glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+	glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+	glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+	planes[0] = row3 + row0;
+	planes[1] = row3 - row0;
+	planes[2] = row3 + row1;
+	planes[3] = row3 - row1;
+	planes[4] = row3 + row2;
+	planes[5] = row3 - row2;
+
+	for (int i = 0; i < 6; ++i)
+	{
+		planes[i] /= glm::length(glm::vec3(planes[i]));
+	}
+}
+
+// instance.xyz = centrul cubului, instance.w = latura; testul foloseste sfera circumscrisa
+inline bool IsInstanceVisible(const glm::vec4 planes[6], const glm::vec4& instance)
+{
+	const float radius = instance.w * 0.8660254f;
+	for (int i = 0; i < 6; ++i)
+	{
+		if (planes[i].x * instance.x + planes[i].y * instance.y + planes[i].z * instance.z + planes[i].w < -radius)
+			return false;
+	}
+	return true;
+}
+
+// Calea CULL_CPU a InstanceCuller: copiaza in pVisible instantele din frustum si intoarce cate sunt.
+inline unsigned int CullInstances(const glm::vec4* pInstances, unsigned int count, const glm::vec4 planes[6], glm::vec4* pVisible)
+{
+	unsigned int visibleCount = 0;
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		if (IsInstanceVisible(planes, pInstances[i]))
+			pVisible[visibleCount++] = pInstances[i];
+	}
+	return visibleCount;
+}
+
+// Ca CullInstances, dar ordonate de la spate la fata pentru blending clasic; cheile de sortare se iau din arena.
+inline unsigned int CullInstancesSorted(const glm::vec4* pInstances, unsigned int count, const glm::vec4 planes[6], const glm::mat4& view,
+	FrameArena& arena, glm::vec4* pVisible)
+{
+	// z-ul in spatiul camerei (randul 2 din view); cu cat e mai mic, cu atat instanta e mai departe
+	const glm::vec4 depthRow(view[0][2], view[1][2], view[2][2], view[3][2]);
+	std::pair<float, unsigned int>* pSortKeys = arena.AllocateArray<std::pair<float, unsigned int>>(count);
+	unsigned int visibleCount = 0;
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		const glm::vec4& instance = pInstances[i];
+		if (IsInstanceVisible(planes, instance))
+			pSortKeys[visibleCount++] = std::make_pair(depthRow.x * instance.x + depthRow.y * instance.y + depthRow.z * instance.z + depthRow.w, i);
+	}
+	std::sort(pSortKeys, pSortKeys + visibleCount,
+		[](const std::pair<float, unsigned int>& a, const std::pair<float, unsigned int>& b) { return a.first < b.first; });
+
+	for (unsigned int i = 0; i < visibleCount; ++i)
+		pVisible[i] = pInstances[pSortKeys[i].second];
+	return visibleCount;
+}
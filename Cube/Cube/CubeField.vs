@@ -0,0 +1,30 @@
+#version 330 core
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aNormal;
+layout(location = 2) in vec3 aColor;
+layout(location = 3) in vec4 aInstance;
+
+out vec3 FragPos;
+out vec3 objectColor;
+out vec3 Normal;
+#ifdef TEMPORAL_CACHE
+out vec4 PrevClipPos;
+#endif
+
+uniform mat4 view;
+uniform mat4 projection;
+#ifdef TEMPORAL_CACHE
+// geometria este statica, deci doar camera anterioara conteaza la reproiectare
+uniform mat4 prevViewProjection;
+#endif
+
+void main()
+{
+    FragPos = aInstance.xyz + aPos * aInstance.w;
+    Normal = aNormal;
+    objectColor = aColor;
+#ifdef TEMPORAL_CACHE
+    PrevClipPos = prevViewProjection * vec4(FragPos, 1.0);
+#endif
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
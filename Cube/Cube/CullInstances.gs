@@ -0,0 +1,25 @@
+#version 330 core
+layout(points) in;
+layout(points, max_vertices = 1) out;
+
+in vec4 vInstance[];
+
+out vec4 visibleInstance;
+
+uniform vec4 frustumPlanes[6];
+
+void main()
+{
+    vec4 instance = vInstance[0];
+    float radius = instance.w * 0.8660254;
+
+    for (int i = 0; i < 6; ++i)
+    {
+        if (dot(frustumPlanes[i].xyz, instance.xyz) + frustumPlanes[i].w < -radius)
+            return;
+    }
+
+    visibleInstance = instance;
+    EmitVertex();
+    EndPrimitive();
+}
@@ -0,0 +1,9 @@
+#version 330 core
+layout(location = 0) in vec4 aInstance;
+
+out vec4 vInstance;
+
+void main()
+{
+    vInstance = aInstance;
+}
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+// Numarul alocarilor prin operator new facute de firul curent. Creste doar in executabilele
+// care inlocuiesc operator new (Cube.cpp); alocarile driverului OpenGL (malloc) nu se vad aici.
+inline size_t& ThreadHeapAllocations()
+{
+	static thread_local size_t count = 0;
+	return count;
+}
+
+// Alocator liniar pentru datele care traiesc un singur cadru: alocarea doar avanseaza un offset,
+// iar Reset() de la inceputul cadrului elibereaza totul odata. Ce nu mai incape se ia de pe heap,
+// iar la urmatorul Reset capacitatea creste la varful atins, deci dupa primele cadre nu mai
+// exista alocari. Destructorii nu se apeleaza, de aceea sunt permise doar tipuri trivial destructibile.
+class FrameArena
+{
+public:
+	explicit FrameArena(size_t capacity = 1 << 20)
+	{
+		Reserve(capacity);
+	}
+
+	void* Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t))
+	{
+		frameBytes += bytes + alignment - 1;
+		if (frameBytes > peakBytes)
+			peakBytes = frameBytes;
+
+		const uintptr_t base = (uintptr_t)buffer.get();
+		const uintptr_t aligned = (base + offset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+		if (aligned + bytes <= base + capacity)
+		{
+			offset = (size_t)(aligned - base) + bytes;
+			return (void*)aligned;
+		}
+
+		// depasire: bloc separat pana la Reset, cand arena creste
+		++overflowCount;
+		overflowBlocks.emplace_back(new unsigned char[bytes + alignment - 1]);
+		const uintptr_t block = (uintptr_t)overflowBlocks.back().get();
+		return (void*)((block + alignment - 1) & ~(uintptr_t)(alignment - 1));
+	}
+
+	// Memorie neinitializata pentru count elemente, valabila pana la urmatorul Reset.
+	template <typename T>
+	T* AllocateArray(size_t count)
+	{
+		static_assert(std::is_trivially_destructible<T>::value, "FrameArena never runs destructors");
+		return (T*)Allocate(count * sizeof(T), alignof(T));
+	}
+
+	void Reset()
+	{
+		if (frameBytes > capacity)
+			Reserve(frameBytes + frameBytes / 2);
+		overflowBlocks.clear();
+		offset = 0;
+		frameBytes = 0;
+	}
+
+	size_t GetCapacity() const
+	{
+		return capacity;
+	}
+
+	size_t GetUsedBytes() const
+	{
+		return offset;
+	}
+
+	// Cel mai mare consum intr-un cadru, inclusiv depasirile.
+	size_t GetPeakBytes() const
+	{
+		return peakBytes;
+	}
+
+	unsigned int GetOverflowCount() const
+	{
+		return overflowCount;
+	}
+
+private:
+	void Reserve(size_t newCapacity)
+	{
+		buffer.reset(new unsigned char[newCapacity]);
+		capacity = newCapacity;
+		offset = 0;
+	}
+
+private:
+	std::unique_ptr<unsigned char[]> buffer;
+	size_t capacity = 0;
+	size_t offset = 0;
+	size_t frameBytes = 0;
+	size_t peakBytes = 0;
+	unsigned int overflowCount = 0;
+	std::vector<std::unique_ptr<unsigned char[]>> overflowBlocks;
+};
+
+// Pool de vectori refolositi intre fire: Acquire intoarce un vector gol care isi pastreaza
+// capacitatea de la folosirea anterioara, Release il pune inapoi. Pentru bufferele tranzitorii
+// care se creeaza si se distrug des, ca sa nu fie realocate de fiecare data.
+template <typename T>
+class VectorPool
+{
+public:
+	explicit VectorPool(size_t maxPooled = 64)
+		: maxPooled(maxPooled)
+	{
+		freeBuffers.reserve(maxPooled);
+	}
+
+	std::vector<T> Acquire()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (freeBuffers.empty())
+		{
+			++misses;
+			return std::vector<T>();
+		}
+		std::vector<T> buffer = std::move(freeBuffers.back());
+		freeBuffers.pop_back();
+		return buffer;
+	}
+
+	void Release(std::vector<T>&& buffer)
+	{
+		buffer.clear();
+		std::lock_guard<std::mutex> lock(mutex);
+		if (buffer.capacity() > 0 && freeBuffers.size() < maxPooled)
+			freeBuffers.push_back(std::move(buffer));
+	}
+
+	// De cate ori Acquire nu a avut un vector liber (si deci urmeaza o alocare noua).
+	size_t GetMissCount()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return misses;
+	}
+
+	size_t GetPooledBytes()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		size_t bytes = 0;
+		for (const std::vector<T>& buffer : freeBuffers)
+			bytes += buffer.capacity() * sizeof(T);
+		return bytes;
+	}
+
+private:
+	std::mutex mutex;
+	std::vector<std::vector<T>> freeBuffers;
+	size_t maxPooled;
+	size_t misses = 0;
+};
+
+// Memoria tranzitorie a buclei de randare: arena cadrului si contorul de alocari pe heap ale
+// firului de randare. Dupa warmupFrames cadre, un cadru fara evenimente (taste, redimensionare,
+// incarcari de chunk-uri) nu trebuie sa aloce nimic; in Debug o alocare opreste programul.
+class FrameMemory
+{
+public:
+	FrameMemory(size_t arenaCapacity = 1 << 20, unsigned int warmupFrames = 120)
+		: arena(arenaCapacity), warmupFrames(warmupFrames)
+	{
+	}
+
+	FrameArena& GetArena()
+	{
+		return arena;
+	}
+
+	void BeginFrame()
+	{
+		arena.Reset();
+		frameStartAllocations = ThreadHeapAllocations();
+		bAllocationsExpected = false;
+	}
+
+	// Cadrul curent face o schimbare care aloca in mod legitim, deci nu se verifica.
+	void ExpectAllocations()
+	{
+		bAllocationsExpected = true;
+	}
+
+	void EndFrame()
+	{
+		const size_t allocations = ThreadHeapAllocations() - frameStartAllocations;
+		lastFrameAllocations = allocations;
+		++frameCount;
+		if (frameCount <= warmupFrames || bAllocationsExpected)
+			return;
+
+		++checkedFrames;
+		if (allocations > 0)
+		{
+			++framesWithAllocations;
+			steadyAllocations += allocations;
+			if (allocations > maxFrameAllocations)
+				maxFrameAllocations = allocations;
+		}
+		assert(allocations == 0 && "heap allocation in a steady-state frame");
+	}
+
+	size_t GetLastFrameAllocations() const
+	{
+		return lastFrameAllocations;
+	}
+
+	void PrintStats() const
+	{
+		std::cout << "Frame arena: capacity " << arena.GetCapacity() / 1024 << " KB, peak " << arena.GetPeakBytes() / 1024
+			<< " KB per frame, " << arena.GetOverflowCount() << " overflows" << std::endl;
+		std::cout << "Heap allocations in steady-state frames: " << checkedFrames << " frames checked, "
+			<< framesWithAllocations << " with allocations (" << steadyAllocations << " total, max "
+			<< maxFrameAllocations << " per frame)" << std::endl;
+	}
+
+private:
+	FrameArena arena;
+	unsigned int warmupFrames;
+	unsigned int frameCount = 0;
+	bool bAllocationsExpected = false;
+
+	size_t frameStartAllocations = 0;
+	size_t lastFrameAllocations = 0;
+	unsigned int checkedFrames = 0;
+	unsigned int framesWithAllocations = 0;
+	size_t steadyAllocations = 0;
+	size_t maxFrameAllocations = 0;
+};
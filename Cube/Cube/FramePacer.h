@@ -0,0 +1,447 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+#include <GL/glew.h>
+#include <glfw3.h>
+
+#include "GpuMemory.h"
+
+enum EPacingMode
+{
+	PACING_VSYNC,
+	PACING_UNCAPPED,
+	PACING_LIMITED
+};
+
+inline const char* GetPacingModeName(EPacingMode mode)
+{
+	switch (mode)
+	{
+	case EPacingMode::PACING_VSYNC:
+		return "vsync";
+	case EPacingMode::PACING_UNCAPPED:
+		return "uncapped";
+	case EPacingMode::PACING_LIMITED:
+		return "limited";
+	}
+	return "unknown";
+}
+
+// medie si varianta calculate incremental (Welford)
+struct RunningStats
+{
+	unsigned int samples = 0;
+	double mean = 0.0;
+	double m2 = 0.0;
+	double minValue = 0.0;
+	double maxValue = 0.0;
+
+	void Add(double value)
+	{
+		if (samples == 0 || value < minValue)
+			minValue = value;
+		if (samples == 0 || value > maxValue)
+			maxValue = value;
+
+		++samples;
+		double delta = value - mean;
+		mean += delta / samples;
+		m2 += delta * (value - mean);
+	}
+
+	double Variance() const
+	{
+		return samples > 1 ? m2 / (samples - 1) : 0.0;
+	}
+};
+
+// Controleaza ritmul cadrelor: vsync, fara limita sau limitare la un FPS tinta
+// (sleep + spin), limiteaza cadrele aflate in executie pe GPU prin glFenceSync si
+// scaleaza dinamic rezolutia de randare cand timpul GPU depaseste bugetul.
+// Bugetul urmeaza ritmul modului: perioada de refresh a monitorului la vsync, perioada
+// FPS-ului tinta la limitare, iar fara limita doar un buget dat explicit (altfel nu se scaleaza).
+// Latenta raportata e masurata pe ceasul GPU: de la inceputul cadrului (GL_TIMESTAMP citit la
+// citirea input-ului) pana la un glQueryCounter pus dupa ultima comanda a cadrului.
+class FramePacer
+{
+public:
+	static const int MAX_FRAMES_IN_FLIGHT = 2;
+
+	FramePacer(EPacingMode mode, double targetFps, int framesInFlight, bool bDynamicResolution, double uncappedBudgetMs = 0.0)
+	{
+		this->targetFps = targetFps > 0.0 ? targetFps : 60.0;
+		this->uncappedBudgetMs = uncappedBudgetMs > 0.0 ? uncappedBudgetMs : 0.0;
+		this->framesInFlight = framesInFlight < 1 ? 1 : (framesInFlight > MAX_FRAMES_IN_FLIGHT ? MAX_FRAMES_IN_FLIGHT : framesInFlight);
+		this->bDynamicResolution = bDynamicResolution;
+
+		for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			fences[i] = 0;
+			fenceFrameStartNs[i] = 0;
+		}
+		glGenQueries(TIMER_QUERIES, timerQueries);
+		glGenQueries(MAX_FRAMES_IN_FLIGHT, completionQueries);
+
+		const GLFWvidmode* pVideoMode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+		refreshRate = pVideoMode && pVideoMode->refreshRate > 0 ? pVideoMode->refreshRate : 60.0;
+
+		SetMode(mode);
+	}
+
+	~FramePacer()
+	{
+		for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			if (fences[i])
+				glDeleteSync(fences[i]);
+		}
+		glDeleteQueries(TIMER_QUERIES, timerQueries);
+		glDeleteQueries(MAX_FRAMES_IN_FLIGHT, completionQueries);
+		DeleteSceneTarget();
+	}
+
+	EPacingMode GetMode() const
+	{
+		return mode;
+	}
+
+	float GetRenderScale() const
+	{
+		return renderScale;
+	}
+
+	// Timpul GPU tinta al unui cadru in modul curent; 0 daca rezolutia nu se scaleaza.
+	double GetGpuBudgetMs() const
+	{
+		switch (mode)
+		{
+		case EPacingMode::PACING_VSYNC:
+			return 1000.0 / refreshRate;
+		case EPacingMode::PACING_LIMITED:
+			return 1000.0 / targetFps;
+		case EPacingMode::PACING_UNCAPPED:
+			return uncappedBudgetMs;
+		}
+		return 0.0;
+	}
+
+	void SetMode(EPacingMode mode)
+	{
+		this->mode = mode;
+		glfwSwapInterval(mode == EPacingMode::PACING_VSYNC ? 1 : 0);
+		bHasPreviousFrame = false;
+
+		// fara buget, rezolutia revine la cea nativa
+		if (GetGpuBudgetMs() <= 0.0)
+			renderScale = 1.0f;
+		framesSinceScaleChange = 0;
+	}
+
+	void NextMode()
+	{
+		SetMode((EPacingMode)((mode + 1) % (EPacingMode::PACING_LIMITED + 1)));
+		std::cout << "Frame pacing: " << GetPacingModeName(mode);
+		if (bDynamicResolution)
+		{
+			const double budgetMs = GetGpuBudgetMs();
+			if (budgetMs > 0.0)
+				std::cout << ", GPU budget " << budgetMs << " ms";
+			else
+				std::cout << ", dynamic resolution off (no --gpu-budget)";
+		}
+		std::cout << std::endl;
+	}
+
+	// Apelat la inceputul cadrului, inainte de citirea input-ului.
+	void BeginFrame()
+	{
+		if (mode == EPacingMode::PACING_LIMITED && bHasPreviousFrame)
+		{
+			WaitUntil(previousFrameStart + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetFps)));
+		}
+
+		// CPU-ul nu are voie sa fie cu mai mult de framesInFlight cadre inaintea GPU-ului
+		const int slot = frameIndex % framesInFlight;
+		if (fences[slot])
+		{
+			// la timeout se asteapta din nou: slotul nu se elibereaza cat timp cadrul e inca pe GPU
+			GLenum result;
+			do
+			{
+				result = glClientWaitSync(fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT_NS);
+			} while (result == GL_TIMEOUT_EXPIRED);
+
+			if (result == GL_WAIT_FAILED)
+			{
+				std::cout << "ERROR::FRAMEPACER:: glClientWaitSync failed" << std::endl;
+				DeleteFence(slot);
+			}
+			else
+			{
+				RetireFence(slot);
+			}
+		}
+		PollFences();
+		ReadTimerQueries();
+
+		const Clock::time_point now = Clock::now();
+		glGetInteger64v(GL_TIMESTAMP, &frameStartGpuNs);
+		if (bHasPreviousFrame)
+		{
+			frameTimeStats[mode].Add(std::chrono::duration<double, std::milli>(now - previousFrameStart).count());
+		}
+		previousFrameStart = now;
+		bHasPreviousFrame = true;
+	}
+
+	// Leaga tinta de randare a scenei (FBO scalat sau framebuffer-ul implicit).
+	void BindSceneTarget(int width, int height)
+	{
+		windowWidth = width;
+		windowHeight = height;
+
+		glBeginQuery(GL_TIME_ELAPSED, timerQueries[frameIndex % TIMER_QUERIES]);
+
+		if (!bDynamicResolution)
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			glViewport(0, 0, width, height);
+			return;
+		}
+
+		int targetWidth = (int)(width * renderScale);
+		int targetHeight = (int)(height * renderScale);
+		if (targetWidth < 1)
+			targetWidth = 1;
+		if (targetHeight < 1)
+			targetHeight = 1;
+		if (targetWidth != sceneWidth || targetHeight != sceneHeight)
+		{
+			CreateSceneTarget(targetWidth, targetHeight);
+		}
+
+		glBindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
+		glViewport(0, 0, sceneWidth, sceneHeight);
+	}
+
+	// Copiaza scena in framebuffer-ul implicit, la rezolutia ferestrei.
+	void ResolveSceneTarget()
+	{
+		if (bDynamicResolution)
+		{
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, sceneFBO);
+			glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+			glBlitFramebuffer(0, 0, sceneWidth, sceneHeight, 0, 0, windowWidth, windowHeight, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			glViewport(0, 0, windowWidth, windowHeight);
+		}
+
+		glEndQuery(GL_TIME_ELAPSED);
+		pendingQueries[frameIndex % TIMER_QUERIES] = true;
+	}
+
+	// Apelat imediat dupa glfwSwapBuffers.
+	void EndFrame()
+	{
+		const int slot = frameIndex % framesInFlight;
+		if (fences[slot])
+		{
+			glDeleteSync(fences[slot]);
+		}
+		// timestamp-ul e scris cand GPU-ul termina comenzile cadrului, deci e gata odata cu fence-ul
+		glQueryCounter(completionQueries[slot], GL_TIMESTAMP);
+		fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		fenceFrameStartNs[slot] = frameStartGpuNs;
+		fenceMode[slot] = mode;
+		++frameIndex;
+	}
+
+	void PrintStats() const
+	{
+		std::cout << "mode\tframes\tmean_ms\tvariance_ms2\tmin_ms\tmax_ms\tlatency_mean_ms\tlatency_max_ms" << std::endl;
+		for (int i = EPacingMode::PACING_VSYNC; i <= EPacingMode::PACING_LIMITED; ++i)
+		{
+			const RunningStats& frameTime = frameTimeStats[i];
+			const RunningStats& latency = latencyStats[i];
+			if (frameTime.samples == 0)
+				continue;
+
+			std::cout << GetPacingModeName((EPacingMode)i) << "\t" << frameTime.samples << "\t" << frameTime.mean << "\t" << frameTime.Variance()
+				<< "\t" << frameTime.minValue << "\t" << frameTime.maxValue << "\t" << latency.mean << "\t" << latency.maxValue << std::endl;
+		}
+	}
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	static const int TIMER_QUERIES = 4;
+	static const GLuint64 FENCE_TIMEOUT_NS = 1000000000;
+
+	// sleep pana aproape de termen, apoi spin pentru precizie
+	void WaitUntil(Clock::time_point deadline) const
+	{
+		const std::chrono::milliseconds spinMargin(2);
+		Clock::time_point now = Clock::now();
+		if (deadline - now > spinMargin)
+		{
+			std::this_thread::sleep_for(deadline - now - spinMargin);
+		}
+		while (Clock::now() < deadline)
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	// Latenta unui cadru: de la inceputul lui (citirea input-ului) pana cand GPU-ul a terminat
+	// ultima lui comanda; ambele momente sunt pe ceasul GPU, independent de cand verifica CPU-ul.
+	void RetireFence(int slot)
+	{
+		GLuint64 completionNs = 0;
+		glGetQueryObjectui64v(completionQueries[slot], GL_QUERY_RESULT, &completionNs);
+		latencyStats[fenceMode[slot]].Add((double)((GLint64)completionNs - fenceFrameStartNs[slot]) / 1.0e6);
+		DeleteFence(slot);
+	}
+
+	void DeleteFence(int slot)
+	{
+		glDeleteSync(fences[slot]);
+		fences[slot] = 0;
+	}
+
+	void PollFences()
+	{
+		for (int i = 0; i < framesInFlight; ++i)
+		{
+			if (!fences[i])
+				continue;
+
+			GLenum result = glClientWaitSync(fences[i], 0, 0);
+			if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)
+				RetireFence(i);
+		}
+	}
+
+	void ReadTimerQueries()
+	{
+		for (int i = 0; i < TIMER_QUERIES; ++i)
+		{
+			if (!pendingQueries[i])
+				continue;
+
+			GLint available = 0;
+			glGetQueryObjectiv(timerQueries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+			if (!available)
+				continue;
+
+			GLuint64 gpuNs = 0;
+			glGetQueryObjectui64v(timerQueries[i], GL_QUERY_RESULT, &gpuNs);
+			pendingQueries[i] = false;
+			AdaptRenderScale(gpuNs / 1.0e6);
+		}
+	}
+
+	void AdaptRenderScale(double gpuMs)
+	{
+		const double budgetMs = GetGpuBudgetMs();
+		if (!bDynamicResolution || budgetMs <= 0.0)
+			return;
+
+		// modificarile de rezolutie se fac cu histerezis, ca sa nu se realoce FBO-ul la fiecare cadru
+		if (++framesSinceScaleChange < SCALE_CHANGE_INTERVAL)
+			return;
+
+		float newScale = renderScale;
+		if (gpuMs > budgetMs * 0.9)
+			newScale = renderScale - SCALE_STEP;
+		else if (gpuMs < budgetMs * 0.6)
+			newScale = renderScale + SCALE_STEP;
+
+		if (newScale < MIN_RENDER_SCALE)
+			newScale = MIN_RENDER_SCALE;
+		if (newScale > 1.0f)
+			newScale = 1.0f;
+
+		if (fabs(newScale - renderScale) > 1e-4f)
+		{
+			renderScale = newScale;
+			framesSinceScaleChange = 0;
+		}
+	}
+
+	void CreateSceneTarget(int width, int height)
+	{
+		DeleteSceneTarget();
+
+		sceneWidth = width;
+		sceneHeight = height;
+
+		glGenFramebuffers(1, &sceneFBO);
+		glBindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
+
+		glGenRenderbuffers(1, &sceneColor);
+		glBindRenderbuffer(GL_RENDERBUFFER, sceneColor);
+		GpuRenderbufferStorage(sceneColor, GL_RGBA8, width, height);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, sceneColor);
+
+		glGenRenderbuffers(1, &sceneDepth);
+		glBindRenderbuffer(GL_RENDERBUFFER, sceneDepth);
+		GpuRenderbufferStorage(sceneDepth, GL_DEPTH24_STENCIL8, width, height);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, sceneDepth);
+
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			std::cout << "ERROR::FRAMEBUFFER:: Scene framebuffer is not complete!" << std::endl;
+		}
+		glBindRenderbuffer(GL_RENDERBUFFER, 0);
+	}
+
+	void DeleteSceneTarget()
+	{
+		if (sceneFBO)
+		{
+			glDeleteFramebuffers(1, &sceneFBO);
+			GpuDeleteRenderbuffers(1, &sceneColor);
+			GpuDeleteRenderbuffers(1, &sceneDepth);
+		}
+		sceneFBO = sceneColor = sceneDepth = 0;
+		sceneWidth = sceneHeight = 0;
+	}
+
+private:
+	static const int SCALE_CHANGE_INTERVAL = 15;
+	static constexpr float SCALE_STEP = 0.05f;
+	static constexpr float MIN_RENDER_SCALE = 0.5f;
+
+	EPacingMode mode;
+	double targetFps;
+	double refreshRate;
+	double uncappedBudgetMs;
+	int framesInFlight;
+	bool bDynamicResolution;
+
+	unsigned int frameIndex = 0;
+	bool bHasPreviousFrame = false;
+	Clock::time_point previousFrameStart;
+	GLint64 frameStartGpuNs = 0;
+
+	GLsync fences[MAX_FRAMES_IN_FLIGHT];
+	GLint64 fenceFrameStartNs[MAX_FRAMES_IN_FLIGHT];
+	EPacingMode fenceMode[MAX_FRAMES_IN_FLIGHT];
+	unsigned int completionQueries[MAX_FRAMES_IN_FLIGHT];
+
+	unsigned int timerQueries[TIMER_QUERIES];
+	bool pendingQueries[TIMER_QUERIES] = {};
+
+	float renderScale = 1.0f;
+	int framesSinceScaleChange = 0;
+	int windowWidth = 0, windowHeight = 0;
+	int sceneWidth = 0, sceneHeight = 0;
+	unsigned int sceneFBO = 0, sceneColor = 0, sceneDepth = 0;
+
+	RunningStats frameTimeStats[EPacingMode::PACING_LIMITED + 1];
+	RunningStats latencyStats[EPacingMode::PACING_LIMITED + 1];
+};
@@ -0,0 +1,421 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <GL/glew.h>
+#include <glm.hpp>
+
+#include "Shader.h"
+#include "CubeField.h"
+#include "FrameMemory.h"
+#include "GpuMemory.h"
+
+enum ECullingMode
+{
+	CULL_NONE,
+	CULL_CPU,
+	CULL_TRANSFORM_FEEDBACK,
+	CULL_COMPUTE
+};
+
+inline const char* GetCullingModeName(ECullingMode mode)
+{
+	switch (mode)
+	{
+	case ECullingMode::CULL_NONE:
+		return "none";
+	case ECullingMode::CULL_CPU:
+		return "CPU";
+	case ECullingMode::CULL_TRANSFORM_FEEDBACK:
+		return "transform feedback";
+	case ECullingMode::CULL_COMPUTE:
+		return "compute";
+	}
+	return "unknown";
+}
+
+// layout impus de glDrawArraysIndirect
+struct DrawArraysIndirectCommand
+{
+	GLuint count;
+	GLuint instanceCount;
+	GLuint first;
+	GLuint baseInstance;
+};
+
+// Deseneaza un camp de cuburi instantiate, cu culling facut pe CPU sau pe GPU.
+// Pe caile GPU, bounding-urile raman in memoria video, iar CPU-ul trimite un numar
+// constant de comenzi indiferent de numarul de instante.
+// Instantele vizibile se scriu pe rand in CULL_RING_SIZE buffere alocate o singura data, ca
+// un cadru nou sa nu astepte desenarea celui anterior. Fara ARB_query_buffer_object, numarul
+// produs de transform feedback se citeste cu intarziere: se deseneaza cel mai recent slot al
+// carui rezultat e deja disponibil, deci lista vizibila poate fi cu pana la doua cadre in urma.
+class InstanceCuller
+{
+public:
+	InstanceCuller(unsigned int cubeVBO, int cubeVertexCount, const std::vector<glm::vec4>& instances)
+	{
+		Init(cubeVBO, cubeVertexCount, instances);
+	}
+
+	~InstanceCuller()
+	{
+		glDeleteVertexArrays(1, &boundsVAO);
+		glDeleteVertexArrays(1, &allVAO);
+		glDeleteVertexArrays(CULL_RING_SIZE, visibleVAOs);
+		GpuDeleteBuffers(1, &boundsVBO);
+		GpuDeleteBuffers(CULL_RING_SIZE, visibleVBOs);
+		GpuDeleteBuffers(CULL_RING_SIZE, indirectBuffers);
+		glDeleteQueries(CULL_RING_SIZE, feedbackQueries);
+	}
+
+	bool IsSupported(ECullingMode mode) const
+	{
+		if (mode == ECullingMode::CULL_COMPUTE)
+			return hasCompute;
+		return true;
+	}
+
+	unsigned int GetInstanceCount() const
+	{
+		return instanceCount;
+	}
+
+	// Numarul de instante vizibile; pe caile complet GPU necesita citirea bufferului indirect.
+	unsigned int ReadVisibleCount() const
+	{
+		if (!UsesIndirectDraw())
+			return visibleCount;
+
+		DrawArraysIndirectCommand command;
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffers[drawSlot]);
+		glGetBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(command), &command);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+		return command.instanceCount;
+	}
+
+	// Caile CPU iau lista instantelor vizibile din arena cadrului.
+	void Cull(ECullingMode mode, const glm::mat4& projection, const glm::mat4& view, FrameArena& arena)
+	{
+		if (!IsSupported(mode))
+			mode = ECullingMode::CULL_TRANSFORM_FEEDBACK;
+		lastMode = mode;
+		writeSlot = (writeSlot + 1) % CULL_RING_SIZE;
+		drawSlot = writeSlot;
+
+		glm::vec4 planes[6];
+		ExtractFrustumPlanes(projection * view, planes);
+
+		switch (mode)
+		{
+		case ECullingMode::CULL_NONE:
+			visibleCount = instanceCount;
+			break;
+		case ECullingMode::CULL_CPU:
+			CullOnCpu(planes, arena);
+			break;
+		case ECullingMode::CULL_TRANSFORM_FEEDBACK:
+			CullWithTransformFeedback(planes);
+			break;
+		case ECullingMode::CULL_COMPUTE:
+			CullWithCompute(planes);
+			break;
+		}
+	}
+
+	// Culling pe CPU urmat de sortarea instantelor vizibile de la spate la fata, pentru blending clasic.
+	void CullSorted(const glm::mat4& projection, const glm::mat4& view, FrameArena& arena)
+	{
+		lastMode = ECullingMode::CULL_CPU;
+		writeSlot = (writeSlot + 1) % CULL_RING_SIZE;
+		drawSlot = writeSlot;
+
+		glm::vec4 planes[6];
+		ExtractFrustumPlanes(projection * view, planes);
+
+		// dimensiunea maxima, ca memoria ceruta arenei sa nu depinda de camera
+		glm::vec4* pVisible = arena.AllocateArray<glm::vec4>(instanceCount);
+		const unsigned int count = CullInstancesSorted(bounds.data(), instanceCount, planes, view, arena, pVisible);
+		UploadVisible(pVisible, count);
+	}
+
+	// Shaderul de desenare trebuie sa fie activ; instanta este citita din atributul 3.
+	void Draw() const
+	{
+		if (lastMode == ECullingMode::CULL_NONE)
+		{
+			glBindVertexArray(allVAO);
+			glDrawArraysInstanced(GL_TRIANGLES, 0, cubeVertexCount, instanceCount);
+			return;
+		}
+
+		glBindVertexArray(visibleVAOs[drawSlot]);
+		if (UsesIndirectDraw())
+		{
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffers[drawSlot]);
+			glDrawArraysIndirect(GL_TRIANGLES, (void*)0);
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+		}
+		else
+		{
+			glDrawArraysInstanced(GL_TRIANGLES, 0, cubeVertexCount, visibleCount);
+		}
+	}
+
+private:
+	void Init(unsigned int cubeVBO, int cubeVertexCount, const std::vector<glm::vec4>& instances)
+	{
+		this->cubeVertexCount = cubeVertexCount;
+		this->instanceCount = (unsigned int)instances.size();
+		this->visibleCount = instanceCount;
+		this->lastMode = ECullingMode::CULL_NONE;
+		this->bounds = instances;
+		this->writeSlot = 0;
+		this->drawSlot = 0;
+
+		hasIndirect = GLEW_VERSION_4_0 || GLEW_ARB_draw_indirect;
+		hasQueryBuffer = hasIndirect && (GLEW_VERSION_4_4 || GLEW_ARB_query_buffer_object);
+		// CullInstances.comp cere #version 430, deci extensiile singure pe un context mai vechi nu ajung
+		hasCompute = hasIndirect && GLEW_VERSION_4_3;
+
+		const GLsizeiptr instanceBytes = instances.size() * sizeof(glm::vec4);
+
+		glGenBuffers(1, &boundsVBO);
+		glBindBuffer(GL_ARRAY_BUFFER, boundsVBO);
+		GpuBufferData(GL_ARRAY_BUFFER, boundsVBO, instanceBytes, instances.data(), GL_STATIC_DRAW);
+
+		glGenBuffers(CULL_RING_SIZE, visibleVBOs);
+		for (unsigned int slot = 0; slot < CULL_RING_SIZE; ++slot)
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, visibleVBOs[slot]);
+			GpuBufferData(GL_ARRAY_BUFFER, visibleVBOs[slot], instanceBytes, NULL, GL_DYNAMIC_COPY);
+			slotCounts[slot] = 0;
+			bSlotPending[slot] = false;
+			bSlotCountKnown[slot] = false;
+		}
+
+		// cate o comanda indirecta pe slot, ca resetarea ei sa nu astepte desenarea cadrului anterior
+		DrawArraysIndirectCommand command = { (GLuint)cubeVertexCount, 0, 0, 0 };
+		glGenBuffers(CULL_RING_SIZE, indirectBuffers);
+		for (unsigned int slot = 0; slot < CULL_RING_SIZE; ++slot)
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, indirectBuffers[slot]);
+			GpuBufferData(GL_ARRAY_BUFFER, indirectBuffers[slot], sizeof(command), &command, GL_DYNAMIC_COPY);
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		glGenQueries(CULL_RING_SIZE, feedbackQueries);
+
+		// sursa pentru pasul de culling prin transform feedback
+		glGenVertexArrays(1, &boundsVAO);
+		glBindVertexArray(boundsVAO);
+		glBindBuffer(GL_ARRAY_BUFFER, boundsVBO);
+		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)0);
+		glEnableVertexAttribArray(0);
+
+		allVAO = CreateDrawVAO(cubeVBO, boundsVBO);
+		for (unsigned int slot = 0; slot < CULL_RING_SIZE; ++slot)
+			visibleVAOs[slot] = CreateDrawVAO(cubeVBO, visibleVBOs[slot]);
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		cullFeedbackShader.reset(new Shader("CullInstances.vs", "CullInstances.gs", { "visibleInstance" }));
+		if (hasCompute)
+		{
+			cullComputeShader.reset(new Shader("CullInstances.comp"));
+			// un driver care nu compileaza shaderul ramane pe transform feedback
+			if (!cullComputeShader->IsLinked())
+			{
+				cullComputeShader.reset();
+				hasCompute = false;
+			}
+		}
+	}
+
+	// acelasi layout ca VAO-ul cubului, plus instanta pe locatia 3
+	unsigned int CreateDrawVAO(unsigned int cubeVBO, unsigned int instanceVBO) const
+	{
+		unsigned int VAO;
+		glGenVertexArrays(1, &VAO);
+		glBindVertexArray(VAO);
+		glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+		glEnableVertexAttribArray(2);
+		glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+		glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)0);
+		glEnableVertexAttribArray(3);
+		glVertexAttribDivisor(3, 1);
+		return VAO;
+	}
+
+	bool UsesIndirectDraw() const
+	{
+		return lastMode == ECullingMode::CULL_COMPUTE ||
+			(lastMode == ECullingMode::CULL_TRANSFORM_FEEDBACK && hasQueryBuffer);
+	}
+
+	void CullOnCpu(const glm::vec4 planes[6], FrameArena& arena)
+	{
+		glm::vec4* pVisible = arena.AllocateArray<glm::vec4>(instanceCount);
+		const unsigned int count = CullInstances(bounds.data(), instanceCount, planes, pVisible);
+		UploadVisible(pVisible, count);
+	}
+
+	// Bufferul slotului are deja dimensiunea maxima; se copiaza doar instantele vizibile.
+	void UploadVisible(const glm::vec4* pVisible, unsigned int count)
+	{
+		visibleCount = count;
+		SetSlotCount(writeSlot, count);
+
+		glBindBuffer(GL_ARRAY_BUFFER, visibleVBOs[writeSlot]);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, visibleCount * sizeof(glm::vec4), pVisible);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	void SetSlotCount(unsigned int slot, unsigned int count)
+	{
+		slotCounts[slot] = count;
+		bSlotPending[slot] = false;
+		bSlotCountKnown[slot] = true;
+	}
+
+	// Numarul a ramas doar in bufferul indirect, deci slotul nu poate fi desenat cu glDrawArraysInstanced.
+	void InvalidateSlotCount(unsigned int slot)
+	{
+		bSlotPending[slot] = false;
+		bSlotCountKnown[slot] = false;
+	}
+
+	// Rezultatul interogarii slotului, daca a ajuns deja; bWait blocheaza pana ajunge.
+	bool TryResolveSlot(unsigned int slot, bool bWait)
+	{
+		if (!bSlotPending[slot])
+			return bSlotCountKnown[slot];
+
+		GLuint available = GL_TRUE;
+		if (!bWait)
+			glGetQueryObjectuiv(feedbackQueries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			return false;
+
+		GLuint count = 0;
+		glGetQueryObjectuiv(feedbackQueries[slot], GL_QUERY_RESULT, &count);
+		SetSlotCount(slot, count);
+		return true;
+	}
+
+	// Cel mai recent slot cu numar cunoscut; daca niciunul nu e gata, se asteapta cel mai vechi.
+	void SelectDrawSlot()
+	{
+		unsigned int oldestSlot = writeSlot;
+		for (unsigned int age = 0; age < CULL_RING_SIZE; ++age)
+		{
+			const unsigned int slot = (writeSlot + CULL_RING_SIZE - age) % CULL_RING_SIZE;
+			if (!bSlotCountKnown[slot] && !bSlotPending[slot])
+				break;
+			if (TryResolveSlot(slot, false))
+			{
+				drawSlot = slot;
+				visibleCount = slotCounts[slot];
+				return;
+			}
+			oldestSlot = slot;
+		}
+
+		TryResolveSlot(oldestSlot, true);
+		drawSlot = oldestSlot;
+		visibleCount = slotCounts[oldestSlot];
+	}
+
+	void CullWithTransformFeedback(const glm::vec4 planes[6])
+	{
+		cullFeedbackShader->Use();
+		cullFeedbackShader->SetVec4Array("frustumPlanes", planes, 6);
+
+		glEnable(GL_RASTERIZER_DISCARD);
+		glBindVertexArray(boundsVAO);
+		glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, visibleVBOs[writeSlot]);
+		glBeginQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, feedbackQueries[writeSlot]);
+		glBeginTransformFeedback(GL_POINTS);
+		glDrawArrays(GL_POINTS, 0, instanceCount);
+		glEndTransformFeedback();
+		glEndQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN);
+		glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+		glDisable(GL_RASTERIZER_DISCARD);
+
+		if (hasQueryBuffer)
+		{
+			// rezultatul interogarii ajunge direct in instanceCount, fara sincronizare cu CPU-ul
+			glBindBuffer(GL_QUERY_BUFFER, indirectBuffers[writeSlot]);
+			glGetQueryObjectuiv(feedbackQueries[writeSlot], GL_QUERY_RESULT, (GLuint*)offsetof(DrawArraysIndirectCommand, instanceCount));
+			glBindBuffer(GL_QUERY_BUFFER, 0);
+			InvalidateSlotCount(writeSlot);
+		}
+		else
+		{
+			// GL 3.3 simplu: rezultatul nu se asteapta in acelasi cadru, ca CPU-ul sa nu stea dupa GPU
+			bSlotPending[writeSlot] = true;
+			bSlotCountKnown[writeSlot] = false;
+			SelectDrawSlot();
+		}
+	}
+
+	void CullWithCompute(const glm::vec4 planes[6])
+	{
+		DrawArraysIndirectCommand command = { (GLuint)cubeVertexCount, 0, 0, 0 };
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffers[writeSlot]);
+		glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(command), &command);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+		cullComputeShader->Use();
+		cullComputeShader->SetVec4Array("frustumPlanes", planes, 6);
+		cullComputeShader->SetUInt("instanceTotal", instanceCount);
+
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, boundsVBO);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, visibleVBOs[writeSlot]);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, indirectBuffers[writeSlot]);
+		glDispatchCompute((instanceCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+		// BUFFER_UPDATE pentru citirea comenzii cu glGetBufferSubData din ReadVisibleCount
+		glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+		InvalidateSlotCount(writeSlot);
+	}
+
+private:
+	static const unsigned int CULL_GROUP_SIZE = 64;
+	static const unsigned int CULL_RING_SIZE = 3;
+
+	int cubeVertexCount;
+	unsigned int instanceCount;
+	unsigned int visibleCount;
+	ECullingMode lastMode;
+
+	bool hasIndirect;
+	bool hasQueryBuffer;
+	bool hasCompute;
+
+	unsigned int boundsVBO;
+	unsigned int boundsVAO;
+	unsigned int allVAO;
+
+	// inelul de instante vizibile: un buffer, un VAO, o comanda indirecta si o interogare pe slot
+	unsigned int visibleVBOs[CULL_RING_SIZE];
+	unsigned int visibleVAOs[CULL_RING_SIZE];
+	unsigned int indirectBuffers[CULL_RING_SIZE];
+	unsigned int feedbackQueries[CULL_RING_SIZE];
+	unsigned int slotCounts[CULL_RING_SIZE];
+	bool bSlotPending[CULL_RING_SIZE];
+	bool bSlotCountKnown[CULL_RING_SIZE];
+	unsigned int writeSlot;
+	unsigned int drawSlot;
+
+	std::unique_ptr<Shader> cullFeedbackShader;
+	std::unique_ptr<Shader> cullComputeShader;
+
+	std::vector<glm::vec4> bounds;
+};
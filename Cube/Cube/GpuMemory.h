@@ -0,0 +1,201 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <unordered_map>
+
+#include <GL/glew.h>
+
+// Contabilitatea memoriei video: octetii fiecarui buffer, fiecarei texturi si fiecarui
+// renderbuffer alocat prin functiile Gpu* de mai jos, folosite in locul apelurilor GL directe.
+// Dimensiunile se calculeaza din formatul intern, deci sunt o estimare: driverul mai poate
+// adauga aliniere sau copii interne.
+
+enum EGpuResourceType
+{
+	GPU_BUFFER,
+	GPU_TEXTURE,
+	GPU_RENDERBUFFER,
+	GPU_RESOURCE_TYPE_COUNT
+};
+
+inline const char* GetGpuResourceTypeName(EGpuResourceType type)
+{
+	switch (type)
+	{
+	case EGpuResourceType::GPU_BUFFER:
+		return "buffers";
+	case EGpuResourceType::GPU_TEXTURE:
+		return "textures";
+	case EGpuResourceType::GPU_RENDERBUFFER:
+		return "renderbuffers";
+	default:
+		break;
+	}
+	return "unknown";
+}
+
+class GpuMemoryTracker
+{
+public:
+	// Inlocuieste dimensiunea inregistrata a resursei (realocarea aceluiasi nume nu se aduna).
+	void Set(EGpuResourceType type, GLuint name, size_t bytes)
+	{
+		size_t& trackedBytes = resources[type][name];
+		totalBytes[type] += bytes;
+		totalBytes[type] -= trackedBytes;
+		trackedBytes = bytes;
+
+		const size_t bytesNow = GetTotalBytes();
+		if (bytesNow > peakBytes)
+			peakBytes = bytesNow;
+	}
+
+	void Remove(EGpuResourceType type, GLuint name)
+	{
+		auto it = resources[type].find(name);
+		if (it == resources[type].end())
+			return;
+		totalBytes[type] -= it->second;
+		resources[type].erase(it);
+	}
+
+	size_t GetBytes(EGpuResourceType type, GLuint name) const
+	{
+		auto it = resources[type].find(name);
+		return it != resources[type].end() ? it->second : 0;
+	}
+
+	size_t GetTotalBytes(EGpuResourceType type) const
+	{
+		return totalBytes[type];
+	}
+
+	size_t GetTotalBytes() const
+	{
+		size_t bytes = 0;
+		for (int type = 0; type < GPU_RESOURCE_TYPE_COUNT; ++type)
+			bytes += totalBytes[type];
+		return bytes;
+	}
+
+	size_t GetResourceCount(EGpuResourceType type) const
+	{
+		return resources[type].size();
+	}
+
+	size_t GetPeakBytes() const
+	{
+		return peakBytes;
+	}
+
+	void PrintStats() const
+	{
+		std::cout << "GPU memory:";
+		for (int type = 0; type < GPU_RESOURCE_TYPE_COUNT; ++type)
+		{
+			std::cout << " " << GetGpuResourceTypeName((EGpuResourceType)type) << " " << GetResourceCount((EGpuResourceType)type)
+				<< " (" << totalBytes[type] / 1024 << " KB),";
+		}
+		std::cout << " total " << GetTotalBytes() / 1024 << " KB, peak " << peakBytes / 1024 << " KB" << std::endl;
+	}
+
+private:
+	std::unordered_map<GLuint, size_t> resources[GPU_RESOURCE_TYPE_COUNT];
+	size_t totalBytes[GPU_RESOURCE_TYPE_COUNT] = {};
+	size_t peakBytes = 0;
+};
+
+inline GpuMemoryTracker& GetGpuMemoryTracker()
+{
+	static GpuMemoryTracker tracker;
+	return tracker;
+}
+
+inline size_t GetTexelBytes(GLint internalFormat)
+{
+	switch (internalFormat)
+	{
+	case GL_RED:
+	case GL_R8:
+		return 1;
+	case GL_R16F:
+		return 2;
+	// formatele RGB fara alfa sunt stocate de drivere pe 4 octeti
+	case GL_RGB:
+	case GL_RGB8:
+	case GL_RGBA:
+	case GL_RGBA8:
+	case GL_R32F:
+	case GL_R32UI:
+	case GL_RG16F:
+	case GL_DEPTH24_STENCIL8:
+	case GL_DEPTH_COMPONENT24:
+		return 4;
+	case GL_RG32F:
+	case GL_RGBA16F:
+		return 8;
+	case GL_RGBA32F:
+		return 16;
+	default:
+		break;
+	}
+	return 4;
+}
+
+// Texelii nivelului de baza plus, pentru mipmap-uri, ai tuturor nivelurilor pana la 1x1.
+inline size_t GetTextureTexels(GLsizei width, GLsizei height, bool bMipmapped)
+{
+	size_t texels = (size_t)width * height;
+	while (bMipmapped && (width > 1 || height > 1))
+	{
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+		texels += (size_t)width * height;
+	}
+	return texels;
+}
+
+// glBufferData pe bufferul legat la target, care trebuie sa fie buffer.
+inline void GpuBufferData(GLenum target, GLuint buffer, GLsizeiptr size, const void* data, GLenum usage)
+{
+	glBufferData(target, size, data, usage);
+	GetGpuMemoryTracker().Set(EGpuResourceType::GPU_BUFFER, buffer, (size_t)size);
+}
+
+inline void GpuDeleteBuffers(GLsizei count, const GLuint* buffers)
+{
+	for (GLsizei i = 0; i < count; ++i)
+		GetGpuMemoryTracker().Remove(EGpuResourceType::GPU_BUFFER, buffers[i]);
+	glDeleteBuffers(count, buffers);
+}
+
+// glTexImage2D pe nivelul 0 al texturii 2D legate, care trebuie sa fie texture. bMipmapped
+// include nivelurile pe care le va crea glGenerateMipmap.
+inline void GpuTexImage2D(GLuint texture, GLint internalFormat, GLsizei width, GLsizei height, GLenum format, GLenum type,
+	const void* data, bool bMipmapped = false)
+{
+	glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, data);
+	GetGpuMemoryTracker().Set(EGpuResourceType::GPU_TEXTURE, texture, GetTextureTexels(width, height, bMipmapped) * GetTexelBytes(internalFormat));
+}
+
+inline void GpuDeleteTextures(GLsizei count, const GLuint* textures)
+{
+	for (GLsizei i = 0; i < count; ++i)
+		GetGpuMemoryTracker().Remove(EGpuResourceType::GPU_TEXTURE, textures[i]);
+	glDeleteTextures(count, textures);
+}
+
+// glRenderbufferStorage pe renderbuffer-ul legat, care trebuie sa fie renderbuffer.
+inline void GpuRenderbufferStorage(GLuint renderbuffer, GLenum internalFormat, GLsizei width, GLsizei height)
+{
+	glRenderbufferStorage(GL_RENDERBUFFER, internalFormat, width, height);
+	GetGpuMemoryTracker().Set(EGpuResourceType::GPU_RENDERBUFFER, renderbuffer, (size_t)width * height * GetTexelBytes(internalFormat));
+}
+
+inline void GpuDeleteRenderbuffers(GLsizei count, const GLuint* renderbuffers)
+{
+	for (GLsizei i = 0; i < count; ++i)
+		GetGpuMemoryTracker().Remove(EGpuResourceType::GPU_RENDERBUFFER, renderbuffers[i]);
+	glDeleteRenderbuffers(count, renderbuffers);
+}
@@ -0,0 +1,300 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include <glfw3.h>
+
+// Coada lock-free cu un singur producator (callback-urile GLFW) si un singur
+// consumator (bucla de randare). Capacity trebuie sa fie putere a lui 2.
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	// Esueaza daca in coada au ramas cel mult reserved locuri libere; asa producatorul
+	// pastreaza loc pentru elementele care nu au voie sa se piarda.
+	bool Push(const T& value, size_t reserved = 0)
+	{
+		const size_t tail = this->tail.load(std::memory_order_relaxed);
+		if (tail - head.load(std::memory_order_acquire) >= Capacity - reserved)
+			return false;
+
+		buffer[tail & (Capacity - 1)] = value;
+		this->tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool Pop(T& value)
+	{
+		const size_t head = this->head.load(std::memory_order_relaxed);
+		if (head == tail.load(std::memory_order_acquire))
+			return false;
+
+		value = buffer[head & (Capacity - 1)];
+		this->head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+private:
+	alignas(64) std::atomic<size_t> head{ 0 };
+	alignas(64) std::atomic<size_t> tail{ 0 };
+	T buffer[Capacity];
+};
+
+enum EInputEventType
+{
+	INPUT_KEY,
+	INPUT_CURSOR,
+	INPUT_SCROLL,
+	INPUT_RESIZE
+};
+
+struct InputEvent
+{
+	EInputEventType type;
+	int key;
+	int action;
+	double x;
+	double y;
+	double timestamp;
+};
+
+struct LatencyStats
+{
+	unsigned int samples = 0;
+	double totalMs = 0.0;
+	double minMs = 0.0;
+	double maxMs = 0.0;
+
+	void Add(double ms)
+	{
+		if (samples == 0 || ms < minMs)
+			minMs = ms;
+		if (samples == 0 || ms > maxMs)
+			maxMs = ms;
+		totalMs += ms;
+		++samples;
+	}
+
+	double Mean() const
+	{
+		return samples ? totalMs / samples : 0.0;
+	}
+};
+
+// Evenimentele sunt puse in coada de callback-uri si consumate o singura data pe cadru:
+// miscarile mouse-ului si scroll-ul se comaseaza intr-o singura actualizare a camerei,
+// iar tastele sunt tratate prin tabele de asocieri.
+// Ultimele RESERVED_EVENTS locuri din coada sunt doar pentru taste si redimensionari, ca un
+// val de miscari ale mouse-ului sa nu piarda un GLFW_RELEASE (tasta ar ramane apasata).
+// Un esantion de cursor pierdut e inlocuit de urmatorul; scroll-ul pierdut se aduna la urmatorul.
+// O tasta apasata si eliberata in acelasi cadru ruleaza actiunile tinute o data, ca apasarea sa nu se piarda.
+class InputSystem
+{
+public:
+	static const int MAX_KEYS = GLFW_KEY_LAST + 1;
+
+	typedef std::function<void()> PressAction;
+	typedef std::function<void(float)> HeldAction;
+
+	std::function<void(float, float)> onCursor;
+	std::function<void(float)> onScroll;
+	std::function<void(int, int)> onResize;
+
+	InputSystem()
+	{
+		for (int i = 0; i < MAX_KEYS; ++i)
+		{
+			keysDown[i] = false;
+			keysPressed[i] = false;
+		}
+	}
+
+	void BindPress(int key, const PressAction& action)
+	{
+		pressBindings.push_back({ key, action });
+	}
+
+	void BindHeld(int key, const HeldAction& action)
+	{
+		heldBindings.push_back({ key, action });
+	}
+
+	void PushKey(int key, int action, double timestamp)
+	{
+		PushReliable({ EInputEventType::INPUT_KEY, key, action, 0.0, 0.0, timestamp });
+	}
+
+	void PushCursor(double x, double y, double timestamp)
+	{
+		if (!queue.Push({ EInputEventType::INPUT_CURSOR, 0, 0, x, y, timestamp }, RESERVED_EVENTS))
+			++droppedCursorSamples;
+	}
+
+	void PushScroll(double xOffset, double yOffset, double timestamp)
+	{
+		pendingScrollX += xOffset;
+		pendingScrollY += yOffset;
+		if (queue.Push({ EInputEventType::INPUT_SCROLL, 0, 0, pendingScrollX, pendingScrollY, timestamp }, RESERVED_EVENTS))
+		{
+			pendingScrollX = 0.0;
+			pendingScrollY = 0.0;
+		}
+	}
+
+	void PushResize(int width, int height, double timestamp)
+	{
+		PushReliable({ EInputEventType::INPUT_RESIZE, 0, 0, (double)width, (double)height, timestamp });
+	}
+
+	void ProcessFrame(float deltaTime)
+	{
+		bool bCursorMoved = false, bResized = false;
+		double cursorX = 0.0, cursorY = 0.0;
+		dispatchedActions = 0;
+		double scrollY = 0.0;
+		int width = 0, height = 0;
+
+		InputEvent event;
+		while (queue.Pop(event))
+		{
+			if (oldestPendingTimestamp < 0.0)
+				oldestPendingTimestamp = event.timestamp;
+
+			switch (event.type)
+			{
+			case EInputEventType::INPUT_KEY:
+				if (event.key < 0 || event.key >= MAX_KEYS)
+					break;
+				if (event.action == GLFW_PRESS)
+				{
+					keysDown[event.key] = true;
+					keysPressed[event.key] = true;
+					for (const PressBinding& binding : pressBindings)
+					{
+						if (binding.key == event.key)
+						{
+							binding.action();
+							++dispatchedActions;
+						}
+					}
+				}
+				else if (event.action == GLFW_RELEASE)
+				{
+					keysDown[event.key] = false;
+				}
+				break;
+			case EInputEventType::INPUT_CURSOR:
+				cursorX = event.x;
+				cursorY = event.y;
+				bCursorMoved = true;
+				break;
+			case EInputEventType::INPUT_SCROLL:
+				scrollY += event.y;
+				break;
+			case EInputEventType::INPUT_RESIZE:
+				width = (int)event.x;
+				height = (int)event.y;
+				bResized = true;
+				break;
+			}
+		}
+
+		if (bResized && onResize)
+		{
+			onResize(width, height);
+			++dispatchedActions;
+		}
+		if (bCursorMoved && onCursor)
+			onCursor((float)cursorX, (float)cursorY);
+		if (scrollY != 0.0 && onScroll)
+			onScroll((float)scrollY);
+
+		for (const HeldBinding& binding : heldBindings)
+		{
+			if (keysDown[binding.key] || keysPressed[binding.key])
+				binding.action(deltaTime);
+		}
+		for (const HeldBinding& binding : heldBindings)
+			keysPressed[binding.key] = false;
+	}
+
+	// Apelat imediat dupa glfwSwapBuffers: latenta de la cel mai vechi eveniment al cadrului.
+	void OnFramePresented(double timestamp)
+	{
+		if (oldestPendingTimestamp < 0.0)
+			return;
+
+		latency.Add((timestamp - oldestPendingTimestamp) * 1000.0);
+		oldestPendingTimestamp = -1.0;
+	}
+
+	const LatencyStats& GetLatencyStats() const
+	{
+		return latency;
+	}
+
+	// Esantioanele de cursor aruncate cand coada era plina pana la zona rezervata.
+	unsigned int GetDroppedCursorSamples() const
+	{
+		return droppedCursorSamples;
+	}
+
+	// Tastele si redimensionarile aruncate pentru ca si zona rezervata era plina; ar trebui sa ramana 0.
+	unsigned int GetDroppedReliableEvents() const
+	{
+		return droppedReliableEvents;
+	}
+
+	// Actiunile de apasare si redimensionarile tratate in ultimul ProcessFrame; miscarea
+	// camerei (taste tinute, cursor, scroll) nu se numara.
+	unsigned int GetDispatchedActions() const
+	{
+		return dispatchedActions;
+	}
+
+private:
+	struct PressBinding
+	{
+		int key;
+		PressAction action;
+	};
+
+	struct HeldBinding
+	{
+		int key;
+		HeldAction action;
+	};
+
+	// Tastele si redimensionarile pot folosi si zona rezervata; ca ea sa se umple, consumatorul
+	// ar trebui sa nu mai citeasca deloc coada.
+	void PushReliable(const InputEvent& event)
+	{
+		if (!queue.Push(event))
+			++droppedReliableEvents;
+	}
+
+private:
+	static const size_t QUEUE_CAPACITY = 1024;
+	static const size_t RESERVED_EVENTS = 128;
+
+	SpscQueue<InputEvent, QUEUE_CAPACITY> queue;
+	bool keysDown[MAX_KEYS];
+	// apasate in lotul curent, chiar daca au fost eliberate inainte de ProcessFrame
+	bool keysPressed[MAX_KEYS];
+
+	std::vector<PressBinding> pressBindings;
+	std::vector<HeldBinding> heldBindings;
+
+	double oldestPendingTimestamp = -1.0;
+	LatencyStats latency;
+	unsigned int droppedCursorSamples = 0;
+	unsigned int droppedReliableEvents = 0;
+	double pendingScrollX = 0.0;
+	double pendingScrollY = 0.0;
+	unsigned int dispatchedActions = 0;
+};
@@ -0,0 +1,21 @@
+#version 330 core
+layout(location = 0) out vec4 accum;
+layout(location = 1) out float weight;
+
+in vec3 Normal;
+in vec3 FragPos;
+in vec3 objectColor;
+
+#include "PhongShading.glsl"
+
+uniform float alpha = 0.25;
+
+// Weighted blended OIT (McGuire & Bavoil 2013). Cu glBlendFuncSeparate(ONE, ONE, ZERO, ONE_MINUS_SRC_ALPHA):
+// accum.rgb = suma culorilor ponderate, accum.a = produsul (1 - alpha) (revealage), weight = suma ponderilor.
+void main()
+{
+    vec3 color = Shade();
+    float w = clamp(pow(min(1.0, alpha * 10.0) + 0.01, 3.0) * 1e8 * pow(1.0 - gl_FragCoord.z * 0.9, 3.0), 1e-2, 3e3);
+    accum = vec4(color * alpha * w, alpha);
+    weight = alpha * w;
+}
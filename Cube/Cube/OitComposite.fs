@@ -0,0 +1,18 @@
+#version 330 core
+out vec4 FragColor;
+
+uniform sampler2D accumTexture;
+uniform sampler2D weightTexture;
+
+// compunerea peste scena cu glBlendFunc(SRC_ALPHA, ONE_MINUS_SRC_ALPHA)
+void main()
+{
+    ivec2 coord = ivec2(gl_FragCoord.xy);
+    vec4 accum = texelFetch(accumTexture, coord, 0);
+    float revealage = accum.a;
+    if (revealage >= 0.9999)
+        discard;
+
+    float weight = texelFetch(weightTexture, coord, 0).r;
+    FragColor = vec4(accum.rgb / max(weight, 1e-5), 1.0 - revealage);
+}
@@ -0,0 +1,31 @@
+#version 430 core
+layout(early_fragment_tests) in;
+
+in vec3 Normal;
+in vec3 FragPos;
+in vec3 objectColor;
+
+#include "PhongShading.glsl"
+
+uniform float alpha = 0.25;
+
+uniform uint maxNodes;
+
+// capul listei fiecarui pixel si nodurile (x = culoare RGBA8, y = adancime, z = urmatorul nod)
+layout(binding = 0, r32ui) uniform coherent uimage2D headPointers;
+layout(binding = 0, offset = 0) uniform atomic_uint nodeCounter;
+
+layout(std430, binding = 0) writeonly buffer FragmentNodes
+{
+    uvec4 nodes[];
+};
+
+void main()
+{
+    uint index = atomicCounterIncrement(nodeCounter);
+    if (index >= maxNodes)
+        return;
+
+    uint next = imageAtomicExchange(headPointers, ivec2(gl_FragCoord.xy), index);
+    nodes[index] = uvec4(packUnorm4x8(vec4(Shade(), alpha)), floatBitsToUint(gl_FragCoord.z), next, 0u);
+}
@@ -0,0 +1,63 @@
+#version 430 core
+out vec4 FragColor;
+
+layout(binding = 0, r32ui) uniform readonly uimage2D headPointers;
+
+layout(std430, binding = 0) readonly buffer FragmentNodes
+{
+    uvec4 nodes[];
+};
+
+// al doilea contor din bufferul cu contorul de noduri al OitLinkedList.fs (vezi Transparency.h)
+layout(binding = 0, offset = 4) uniform atomic_uint truncatedFragments;
+
+const uint END_OF_LIST = 0xFFFFFFFFu;
+const int MAX_FRAGMENTS = 32;
+// plafonul parcurgerii unei liste, ca un pointer gresit sa nu blocheze shaderul
+const int MAX_LIST_LENGTH = 1024;
+
+// Sorteaza fragmentele pixelului dupa adancime si le compune de la spate la fata.
+// Rezultatul este premultiplicat: glBlendFunc(ONE, ONE_MINUS_SRC_ALPHA).
+// Fragmentele de dupa primele MAX_FRAGMENTS ale listei nu intra in compunere; se numara in truncatedFragments.
+void main()
+{
+    uint index = imageLoad(headPointers, ivec2(gl_FragCoord.xy)).r;
+    if (index == END_OF_LIST)
+        discard;
+
+    uvec2 fragments[MAX_FRAGMENTS];
+    int count = 0;
+    for (int length = 0; index != END_OF_LIST && length < MAX_LIST_LENGTH; ++length)
+    {
+        uvec4 node = nodes[index];
+        if (count < MAX_FRAGMENTS)
+            fragments[count++] = node.xy;
+        else
+            atomicCounterIncrement(truncatedFragments);
+        index = node.z;
+    }
+
+    for (int i = 1; i < count; ++i)
+    {
+        uvec2 fragment = fragments[i];
+        float depth = uintBitsToFloat(fragment.y);
+        int j = i - 1;
+        while (j >= 0 && uintBitsToFloat(fragments[j].y) < depth)
+        {
+            fragments[j + 1] = fragments[j];
+            --j;
+        }
+        fragments[j + 1] = fragment;
+    }
+
+    vec3 color = vec3(0.0);
+    float transmittance = 1.0;
+    for (int i = 0; i < count; ++i)
+    {
+        vec4 fragment = unpackUnorm4x8(fragments[i].x);
+        color = fragment.rgb * fragment.a + color * (1.0 - fragment.a);
+        transmittance *= 1.0 - fragment.a;
+    }
+
+    FragColor = vec4(color, 1.0 - transmittance);
+}
@@ -6,15 +6,27 @@ layout(location = 2) in vec3 aColor;
 out vec3 FragPos;
 out vec3 objectColor;
 out vec3 Normal;
+#ifdef TEMPORAL_CACHE
+out vec4 PrevClipPos;
+#endif
 
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
+#ifdef TEMPORAL_CACHE
+// pozitia aceluiasi punct in cadrul anterior, pentru reproiectarea din TemporalCache
+uniform mat4 prevModel;
+uniform mat4 prevViewProjection;
+#endif
+
 void main()
 {
     FragPos = vec3(model * vec4(aPos, 1.0));
     Normal = mat3(transpose(inverse(model))) * aNormal;
     objectColor = aColor;
+#ifdef TEMPORAL_CACHE
+    PrevClipPos = prevViewProjection * prevModel * vec4(aPos, 1.0);
+#endif
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
\ No newline at end of file
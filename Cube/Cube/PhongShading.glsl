@@ -0,0 +1,46 @@
+// Modelul de iluminare Phong al cuburilor, inclus cu #include "PhongShading.glsl" (vezi Shader.h).
+// Shaderul care il include declara intrarile Normal, FragPos si objectColor.
+
+uniform vec3 lightPos;
+uniform vec3 viewPos;
+uniform vec3 lightColor;
+
+uniform float aV = 0.5;
+uniform float dV = 0.5;
+uniform float sV = 0.5;
+uniform float sE = 1.0;
+uniform float constantAt = 0.5;
+uniform float linearAt = 0.5;
+uniform float squareAt = 0.5;
+
+float Attenuation()
+{
+    float distance = length(lightPos - FragPos);
+    return 1.0 / (constantAt + linearAt + squareAt * distance * distance);
+}
+
+// Difuza atenuata a luminii principale; nu depinde de camera (CachedPhongLight.fs o pastreaza intre cadre).
+vec3 MainLightDiffuse(vec3 norm)
+{
+    vec3 lightDir = normalize(lightPos - FragPos);
+    return Attenuation() * lightColor * dV * max(dot(norm, lightDir), 0.0);
+}
+
+// Ambientala si speculara atenuata, partea care depinde de camera.
+vec3 ViewDependentLight(vec3 norm)
+{
+    vec3 lightDir = normalize(lightPos - FragPos);
+    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), sE);
+
+    vec3 ambiental = (lightColor * aV);
+    vec3 specularar = sV * spec * lightColor;
+    return ambiental + Attenuation() * specularar;
+}
+
+vec3 Shade()
+{
+    vec3 norm = normalize(Normal);
+    return (ViewDependentLight(norm) + MainLightDiffuse(norm)) * objectColor;
+}
@@ -0,0 +1,311 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+#include <glm.hpp>
+
+#include "AssetPath.h"
+
+class Shader
+{
+public:
+	Shader(const char* vertexPath, const char* fragmentPath)
+	{
+		Init(vertexPath, fragmentPath);
+	}
+
+	// program fara etapa de fragment, ale carui iesiri sunt capturate prin transform feedback
+	Shader(const char* vertexPath, const char* geometryPath, const std::vector<const char*>& feedbackVaryings)
+	{
+		InitFeedback(vertexPath, geometryPath, feedbackVaryings);
+	}
+
+	explicit Shader(const char* computePath)
+	{
+		InitCompute(computePath);
+	}
+
+	~Shader()
+	{
+		glDeleteProgram(ID);
+	}
+
+	void Use() const
+	{
+		glUseProgram(ID);
+	}
+
+	unsigned int GetID() const
+	{
+		return ID;
+	}
+
+	// false daca programul nu s-a putut lega (erorile sunt deja afisate de CheckCompileErrors)
+	bool IsLinked() const
+	{
+		GLint linked = GL_FALSE;
+		glGetProgramiv(ID, GL_LINK_STATUS, &linked);
+		return linked == GL_TRUE;
+	}
+
+	unsigned int loc_model_matrix;
+	unsigned int loc_view_matrix;
+	unsigned int loc_projection_matrix;
+
+	// Locatia din tabela construita la link (sortata dupa hash-ul FNV-1a al numelui, cautare
+	// binara), fara apel GL si fara std::string; -1 (ignorat de glUniform*) daca uniforma nu
+	// exista sau a fost eliminata de compilator.
+	GLint GetUniformLocation(const char* name) const
+	{
+		const uint32_t hash = HashUniformName(name);
+		auto uniform = std::lower_bound(uniforms.begin(), uniforms.end(), hash,
+			[](const UniformLocation& uniform, uint32_t hash) { return uniform.hash < hash; });
+		for (; uniform != uniforms.end() && uniform->hash == hash; ++uniform)
+		{
+			if (uniform->name == name)
+				return uniform->location;
+		}
+		return -1;
+	}
+
+	void SetVec3(const char* name, const glm::vec3& value) const
+	{
+		glUniform3fv(GetUniformLocation(name), 1, &value[0]);
+	}
+	void SetVec3(const char* name, float x, float y, float z) const
+	{
+		glUniform3f(GetUniformLocation(name), x, y, z);
+	}
+	void SetVec4Array(const char* name, const glm::vec4* values, int count) const
+	{
+		glUniform4fv(GetUniformLocation(name), count, &values[0][0]);
+	}
+	void SetInt(const char* name, int iValue) const
+	{
+		glUniform1i(GetUniformLocation(name), iValue);
+	}
+	void SetFloat(const char* name, float fValue) const
+	{
+		glUniform1f(GetUniformLocation(name), fValue);
+	}
+	void SetUInt(const char* name, unsigned int uValue) const
+	{
+		glUniform1ui(GetUniformLocation(name), uValue);
+	}
+	void SetMat4(const char* name, const glm::mat4& mat) const
+	{
+		glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
+	}
+
+private:
+	void Init(const char* vertexPath, const char* fragmentPath)
+	{
+		unsigned int vertex = CompileStage(GL_VERTEX_SHADER, vertexPath, "VERTEX");
+		unsigned int fragment = CompileStage(GL_FRAGMENT_SHADER, fragmentPath, "FRAGMENT");
+
+		ID = glCreateProgram();
+		glAttachShader(ID, vertex);
+		glAttachShader(ID, fragment);
+		glLinkProgram(ID);
+		CheckCompileErrors(ID, "PROGRAM");
+		CacheUniformLocations();
+
+		glDeleteShader(vertex);
+		glDeleteShader(fragment);
+	}
+
+	void InitFeedback(const char* vertexPath, const char* geometryPath, const std::vector<const char*>& feedbackVaryings)
+	{
+		unsigned int vertex = CompileStage(GL_VERTEX_SHADER, vertexPath, "VERTEX");
+		unsigned int geometry = CompileStage(GL_GEOMETRY_SHADER, geometryPath, "GEOMETRY");
+
+		ID = glCreateProgram();
+		glAttachShader(ID, vertex);
+		glAttachShader(ID, geometry);
+		glTransformFeedbackVaryings(ID, (GLsizei)feedbackVaryings.size(), feedbackVaryings.data(), GL_INTERLEAVED_ATTRIBS);
+		glLinkProgram(ID);
+		CheckCompileErrors(ID, "PROGRAM");
+		CacheUniformLocations();
+
+		glDeleteShader(vertex);
+		glDeleteShader(geometry);
+	}
+
+	void InitCompute(const char* computePath)
+	{
+		unsigned int compute = CompileStage(GL_COMPUTE_SHADER, computePath, "COMPUTE");
+
+		ID = glCreateProgram();
+		glAttachShader(ID, compute);
+		glLinkProgram(ID);
+		CheckCompileErrors(ID, "PROGRAM");
+		CacheUniformLocations();
+
+		glDeleteShader(compute);
+	}
+
+	// Sursa se citeste direct intr-un singur buffer de dimensiunea fisierului.
+	unsigned int CompileStage(GLenum stage, const char* path, const char* type)
+	{
+		std::string code;
+		if (!ReadSourceFile(path, code))
+			std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
+		ExpandIncludes(code);
+		const char* shaderCode = code.c_str();
+		const GLint length = (GLint)code.size();
+
+		unsigned int shader = glCreateShader(stage);
+		glShaderSource(shader, 1, &shaderCode, &length);
+		glCompileShader(shader);
+		CheckCompileErrors(shader, type);
+		return shader;
+	}
+
+	static bool ReadSourceFile(const char* path, std::string& code)
+	{
+		code.clear();
+		std::ifstream shaderFile(ResolveAssetPath(path), std::ios::binary | std::ios::ate);
+		if (shaderFile)
+		{
+			code.resize((size_t)shaderFile.tellg());
+			shaderFile.seekg(0);
+			shaderFile.read(&code[0], (std::streamsize)code.size());
+		}
+		if (!shaderFile)
+		{
+			code.clear();
+			return false;
+		}
+		return true;
+	}
+
+	// Fiecare linie #include "fisier" e inlocuita cu fisierul (un singur nivel, fara includeri
+	// in fisierele incluse), intre directive #line, ca erorile sa indice linia din shader.
+	// Linia #version a unui shader inclus ramane goala, ca el sa poata fi compilat si singur.
+	static void ExpandIncludes(std::string& code)
+	{
+		const char* directive = "#include \"";
+		const size_t directiveLength = std::strlen(directive);
+		if (code.find(directive) == std::string::npos)
+			return;
+
+		std::string expanded;
+		expanded.reserve(code.size());
+		size_t lineStart = 0;
+		int lineNumber = 1;
+		while (lineStart < code.size())
+		{
+			size_t lineEnd = code.find('\n', lineStart);
+			lineEnd = lineEnd == std::string::npos ? code.size() : lineEnd + 1;
+
+			const size_t nameEnd = code.find('"', lineStart + directiveLength);
+			if (code.compare(lineStart, directiveLength, directive) == 0 && nameEnd < lineEnd)
+			{
+				const std::string name = code.substr(lineStart + directiveLength, nameEnd - lineStart - directiveLength);
+				std::string included;
+				if (!ReadSourceFile(name.c_str(), included))
+					std::cout << "ERROR::SHADER::INCLUDE_NOT_FOUND: " << name << std::endl;
+				if (included.compare(0, 8, "#version") == 0)
+					included.erase(0, std::min(included.find('\n'), included.size()));
+
+				expanded += "#line 1\n";
+				expanded += included;
+				if (!included.empty() && included.back() != '\n')
+					expanded += '\n';
+				expanded += "#line " + std::to_string(lineNumber + 1) + "\n";
+			}
+			else
+			{
+				expanded.append(code, lineStart, lineEnd - lineStart);
+			}
+
+			lineStart = lineEnd;
+			++lineNumber;
+		}
+		code.swap(expanded);
+	}
+
+	// Toate uniformele active, cu numele tablourilor fara sufixul "[0]".
+	void CacheUniformLocations()
+	{
+		GLint uniformCount = 0, maxNameLength = 0;
+		glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &uniformCount);
+		glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+		std::vector<GLchar> name(maxNameLength > 0 ? maxNameLength : 1);
+		uniforms.clear();
+		uniforms.reserve(uniformCount);
+		for (GLint i = 0; i < uniformCount; ++i)
+		{
+			GLsizei length = 0;
+			GLint size = 0;
+			GLenum type = 0;
+			glGetActiveUniform(ID, (GLuint)i, (GLsizei)name.size(), &length, &size, &type, name.data());
+
+			UniformLocation uniform;
+			uniform.name.assign(name.data(), (size_t)length);
+			if (uniform.name.size() > 3 && uniform.name.compare(uniform.name.size() - 3, 3, "[0]") == 0)
+				uniform.name.resize(uniform.name.size() - 3);
+
+			// uniformele din blocuri (UBO/SSBO) nu au locatie
+			uniform.location = glGetUniformLocation(ID, uniform.name.c_str());
+			if (uniform.location < 0)
+				continue;
+			uniform.hash = HashUniformName(uniform.name.c_str());
+			uniforms.push_back(uniform);
+		}
+
+		std::sort(uniforms.begin(), uniforms.end(),
+			[](const UniformLocation& a, const UniformLocation& b) { return a.hash < b.hash; });
+	}
+
+	// FNV-1a
+	static uint32_t HashUniformName(const char* name)
+	{
+		uint32_t hash = 2166136261u;
+		for (; *name; ++name)
+			hash = (hash ^ (unsigned char)*name) * 16777619u;
+		return hash;
+	}
+
+	void CheckCompileErrors(unsigned int shader, const char* type)
+	{
+		GLint success;
+		GLchar infoLog[1024];
+		if (std::strcmp(type, "PROGRAM") != 0)
+		{
+			glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+			if (!success)
+			{
+				glGetShaderInfoLog(shader, 1024, NULL, infoLog);
+				std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+			}
+		}
+		else
+		{
+			glGetProgramiv(shader, GL_LINK_STATUS, &success);
+			if (!success)
+			{
+				glGetProgramInfoLog(shader, 1024, NULL, infoLog);
+				std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+			}
+		}
+	}
+private:
+	struct UniformLocation
+	{
+		uint32_t hash;
+		GLint location;
+		std::string name;
+	};
+
+	unsigned int ID;
+	std::vector<UniformLocation> uniforms;
+};
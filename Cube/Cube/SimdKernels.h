@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+
+// Tabela de rutine implementata de fiecare unitate de compilare specifica unui set de
+// instructiuni. Lucreaza doar pe float*, ca fisierele compilate cu -mavx2 / -mavx512f
+// sa nu instantieze functii inline (glm, std) folosite si de restul programului.
+struct SimdKernels
+{
+	// aStride = 0 inseamna aceeasi matrice a pentru toate elementele
+	void (*multiplyMat4)(const float* a, size_t aStride, const float* b, float* out, size_t count);
+	void (*quatToMat4)(const float* q, float* out, size_t count);
+	void (*transformPoints)(const float* m, const float* points, float* out, size_t count);
+	void (*transformAabbs)(const float* m, const float* boxes, float* out, size_t count);
+	void (*sinCos)(const float* x, float* s, float* c, size_t count);
+};
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SIMD_X86 1
+namespace simd_sse4 { extern const SimdKernels kernels; }
+namespace simd_avx2 { extern const SimdKernels kernels; }
+namespace simd_avx512 { extern const SimdKernels kernels; }
+#endif
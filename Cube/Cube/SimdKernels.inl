@@ -0,0 +1,306 @@
+// Rutinele comune tuturor nivelurilor SIMD. Se include dintr-o unitate de compilare
+// care a definit deja, intr-un namespace anonim, tipul vfloat / vmask, LANES (numarul
+// de benzi de 128 de biti dintr-un registru) si primitivele folosite mai jos.
+// Fiecare banda de 128 de biti tine o coloana de matrice, un punct sau un quaternion.
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	const float TWO_OVER_PI = 0.636619772367581343f;
+	const float DP1 = 1.5703125f;
+	const float DP2 = 4.837512969970703125e-4f;
+	const float DP3 = 7.54978995489188216e-8f;
+	const float S1 = -1.6666654611e-1f;
+	const float S2 = 8.3321608736e-3f;
+	const float S3 = -1.9515295891e-4f;
+	const float C1 = 4.166664568298827e-2f;
+	const float C2 = -1.388731625493765e-3f;
+	const float C3 = 2.443315711809948e-5f;
+
+	template <int k>
+	inline vfloat SplatInLane(vfloat v)
+	{
+		return Shuffle<(k << 6) | (k << 4) | (k << 2) | k>(v, v);
+	}
+
+	// transpunere 4x4 in interiorul fiecarei benzi
+	inline void TransposeLanes(vfloat& r0, vfloat& r1, vfloat& r2, vfloat& r3)
+	{
+		vfloat t0 = UnpackLo(r0, r1);
+		vfloat t1 = UnpackLo(r2, r3);
+		vfloat t2 = UnpackHi(r0, r1);
+		vfloat t3 = UnpackHi(r2, r3);
+		r0 = Shuffle<0x44>(t0, t1);
+		r1 = Shuffle<0xEE>(t0, t1);
+		r2 = Shuffle<0x44>(t2, t3);
+		r3 = Shuffle<0xEE>(t2, t3);
+	}
+
+	// Scrie banda j din a la p + j * stride, apoi banda j din b la p + j * stride + offsetB,
+	// in ordine crescatoare, astfel incat suprapunerile cu elementul urmator sa fie corecte.
+	inline void StoreLanes(float* p, size_t stride, vfloat a, size_t offsetB = 0, const vfloat* b = nullptr)
+	{
+		alignas(64) float ta[LANES * 4];
+		alignas(64) float tb[LANES * 4];
+		Store(ta, a);
+		if (b)
+			Store(tb, *b);
+
+		for (int j = 0; j < LANES; ++j)
+		{
+			memcpy(p + j * stride, ta + 4 * j, 4 * sizeof(float));
+			if (b)
+				memcpy(p + j * stride + offsetB, tb + 4 * j, 4 * sizeof(float));
+		}
+	}
+
+	void MultiplyMat4Kernel(const float* a, size_t aStride, const float* b, float* out, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float* ai = a + i * aStride;
+			const float* bi = b + 16 * i;
+			float* oi = out + 16 * i;
+
+			vfloat a0 = BroadcastLane(ai);
+			vfloat a1 = BroadcastLane(ai + 4);
+			vfloat a2 = BroadcastLane(ai + 8);
+			vfloat a3 = BroadcastLane(ai + 12);
+
+			for (int j = 0; j < 4; j += LANES)
+			{
+				vfloat bj = Load(bi + 4 * j);
+				vfloat acc = Mul(a0, SplatInLane<0>(bj));
+				acc = MulAdd(a1, SplatInLane<1>(bj), acc);
+				acc = MulAdd(a2, SplatInLane<2>(bj), acc);
+				acc = MulAdd(a3, SplatInLane<3>(bj), acc);
+				Store(oi + 4 * j, acc);
+			}
+		}
+	}
+
+	void QuatToMat4Scalar(const float* q, float* m)
+	{
+		const float x = q[0], y = q[1], z = q[2], w = q[3];
+		const float xx = x * x, yy = y * y, zz = z * z;
+		const float xy = x * y, xz = x * z, yz = y * z;
+		const float wx = w * x, wy = w * y, wz = w * z;
+
+		m[0] = 1.0f - 2.0f * (yy + zz);
+		m[1] = 2.0f * (xy + wz);
+		m[2] = 2.0f * (xz - wy);
+		m[3] = 0.0f;
+		m[4] = 2.0f * (xy - wz);
+		m[5] = 1.0f - 2.0f * (xx + zz);
+		m[6] = 2.0f * (yz + wx);
+		m[7] = 0.0f;
+		m[8] = 2.0f * (xz + wy);
+		m[9] = 2.0f * (yz - wx);
+		m[10] = 1.0f - 2.0f * (xx + yy);
+		m[11] = 0.0f;
+		m[12] = 0.0f;
+		m[13] = 0.0f;
+		m[14] = 0.0f;
+		m[15] = 1.0f;
+	}
+
+	void QuatToMat4Kernel(const float* q, float* out, size_t count)
+	{
+		const size_t block = 4 * LANES;
+		const vfloat one = Set1(1.0f);
+		const vfloat two = Set1(2.0f);
+		const vfloat zero = Set1(0.0f);
+
+		size_t i = 0;
+		for (; i + block <= count; i += block)
+		{
+			// banda j a registrului k contine quaternionul i + 4 * j + k
+			vfloat x = LoadLanes(q + 4 * i, 16);
+			vfloat y = LoadLanes(q + 4 * (i + 1), 16);
+			vfloat z = LoadLanes(q + 4 * (i + 2), 16);
+			vfloat w = LoadLanes(q + 4 * (i + 3), 16);
+			TransposeLanes(x, y, z, w);
+
+			vfloat xx = Mul(x, x), yy = Mul(y, y), zz = Mul(z, z);
+			vfloat xy = Mul(x, y), xz = Mul(x, z), yz = Mul(y, z);
+			vfloat wx = Mul(w, x), wy = Mul(w, y), wz = Mul(w, z);
+
+			vfloat c0[4] = { Sub(one, Mul(two, Add(yy, zz))), Mul(two, Add(xy, wz)), Mul(two, Sub(xz, wy)), zero };
+			vfloat c1[4] = { Mul(two, Sub(xy, wz)), Sub(one, Mul(two, Add(xx, zz))), Mul(two, Add(yz, wx)), zero };
+			vfloat c2[4] = { Mul(two, Add(xz, wy)), Mul(two, Sub(yz, wx)), Sub(one, Mul(two, Add(xx, yy))), zero };
+			TransposeLanes(c0[0], c0[1], c0[2], c0[3]);
+			TransposeLanes(c1[0], c1[1], c1[2], c1[3]);
+			TransposeLanes(c2[0], c2[1], c2[2], c2[3]);
+
+			const vfloat c3 = BlendW(zero, one);
+			for (int k = 0; k < 4; ++k)
+			{
+				float* m = out + 16 * (i + k);
+				StoreLanes(m, 64, c0[k]);
+				StoreLanes(m + 4, 64, c1[k]);
+				StoreLanes(m + 8, 64, c2[k]);
+				StoreLanes(m + 12, 64, c3);
+			}
+		}
+		for (; i < count; ++i)
+		{
+			QuatToMat4Scalar(q + 4 * i, out + 16 * i);
+		}
+	}
+
+	void TransformPointScalar(const float* m, const float* p, float* out)
+	{
+		const float x = p[0], y = p[1], z = p[2];
+		for (int r = 0; r < 3; ++r)
+		{
+			out[r] = m[r] * x + m[4 + r] * y + m[8 + r] * z + m[12 + r];
+		}
+	}
+
+	void TransformPointsKernel(const float* m, const float* points, float* out, size_t count)
+	{
+		const vfloat c0 = BroadcastLane(m);
+		const vfloat c1 = BroadcastLane(m + 4);
+		const vfloat c2 = BroadcastLane(m + 8);
+		const vfloat c3 = BroadcastLane(m + 12);
+
+		// incarcarile de 4 float-uri citesc si x-ul punctului urmator, deci ultimul punct e tratat scalar
+		size_t i = 0;
+		for (; i + LANES < count; i += LANES)
+		{
+			vfloat p = LoadLanes(points + 3 * i, 3);
+			vfloat acc = MulAdd(c0, SplatInLane<0>(p), c3);
+			acc = MulAdd(c1, SplatInLane<1>(p), acc);
+			acc = MulAdd(c2, SplatInLane<2>(p), acc);
+			StoreLanes(out + 3 * i, 3, BlendW(acc, p));
+		}
+		for (; i < count; ++i)
+		{
+			TransformPointScalar(m, points + 3 * i, out + 3 * i);
+		}
+	}
+
+	void TransformAabbScalar(const float* m, const float* box, float* out)
+	{
+		float center[3], extent[3];
+		for (int k = 0; k < 3; ++k)
+		{
+			center[k] = (box[k] + box[3 + k]) * 0.5f;
+			extent[k] = (box[3 + k] - box[k]) * 0.5f;
+		}
+		for (int r = 0; r < 3; ++r)
+		{
+			float c = m[r] * center[0] + m[4 + r] * center[1] + m[8 + r] * center[2] + m[12 + r];
+			float e = fabsf(m[r]) * extent[0] + fabsf(m[4 + r]) * extent[1] + fabsf(m[8 + r]) * extent[2];
+			out[r] = c - e;
+			out[3 + r] = c + e;
+		}
+	}
+
+	void TransformAabbsKernel(const float* m, const float* boxes, float* out, size_t count)
+	{
+		const vfloat c0 = BroadcastLane(m);
+		const vfloat c1 = BroadcastLane(m + 4);
+		const vfloat c2 = BroadcastLane(m + 8);
+		const vfloat c3 = BroadcastLane(m + 12);
+		const vfloat a0 = Abs(c0);
+		const vfloat a1 = Abs(c1);
+		const vfloat a2 = Abs(c2);
+		const vfloat half = Set1(0.5f);
+
+		size_t i = 0;
+		for (; i + LANES < count; i += LANES)
+		{
+			vfloat boxMin = LoadLanes(boxes + 6 * i, 6);
+			vfloat boxMax = LoadLanes(boxes + 6 * i + 3, 6);
+			vfloat center = Mul(Add(boxMin, boxMax), half);
+			vfloat extent = Mul(Sub(boxMax, boxMin), half);
+
+			vfloat newCenter = MulAdd(c0, SplatInLane<0>(center), c3);
+			newCenter = MulAdd(c1, SplatInLane<1>(center), newCenter);
+			newCenter = MulAdd(c2, SplatInLane<2>(center), newCenter);
+			vfloat newExtent = Mul(a0, SplatInLane<0>(extent));
+			newExtent = MulAdd(a1, SplatInLane<1>(extent), newExtent);
+			newExtent = MulAdd(a2, SplatInLane<2>(extent), newExtent);
+
+			vfloat newMin = BlendW(Sub(newCenter, newExtent), boxMin);
+			vfloat newMax = BlendW(Add(newCenter, newExtent), boxMax);
+			StoreLanes(out + 6 * i, 6, newMin, 3, &newMax);
+		}
+		for (; i < count; ++i)
+		{
+			TransformAabbScalar(m, boxes + 6 * i, out + 6 * i);
+		}
+	}
+
+	// Un bloc de 4 * LANES valori.
+	void SinCosBlock(const float* x, float* s, float* c)
+	{
+		const vfloat one = Set1(1.0f);
+		const vfloat two = Set1(2.0f);
+		const vfloat half = Set1(0.5f);
+		const vfloat quarter = Set1(0.25f);
+
+		vfloat v = Load(x);
+		vfloat q = Round(Mul(v, Set1(TWO_OVER_PI)));
+		vfloat r = MulAdd(q, Set1(-DP1), v);
+		r = MulAdd(q, Set1(-DP2), r);
+		r = MulAdd(q, Set1(-DP3), r);
+		vfloat r2 = Mul(r, r);
+
+		vfloat ps = MulAdd(r2, Set1(S3), Set1(S2));
+		ps = MulAdd(r2, ps, Set1(S1));
+		ps = MulAdd(Mul(r, r2), ps, r);
+
+		vfloat pc = MulAdd(r2, Set1(C3), Set1(C2));
+		pc = MulAdd(r2, pc, Set1(C1));
+		pc = MulAdd(Mul(r2, r2), pc, Sub(one, Mul(half, r2)));
+
+		vfloat qHalf = Floor(Mul(q, half));
+		vfloat odd = Sub(q, Mul(two, qHalf));
+		vfloat sinNegative = Sub(qHalf, Mul(two, Floor(Mul(q, quarter))));
+		vfloat q1 = Add(q, one);
+		vfloat cosNegative = Sub(Floor(Mul(q1, half)), Mul(two, Floor(Mul(q1, quarter))));
+
+		vmask swap = GreaterThan(odd, half);
+		Store(s, Mul(Select(swap, pc, ps), Sub(one, Mul(two, sinNegative))));
+		Store(c, Mul(Select(swap, ps, pc), Sub(one, Mul(two, cosNegative))));
+	}
+
+	void SinCosKernel(const float* x, float* s, float* c, size_t count)
+	{
+		const size_t block = 4 * LANES;
+
+		size_t i = 0;
+		for (; i + block <= count; i += block)
+		{
+			SinCosBlock(x + i, s + i, c + i);
+		}
+
+		// Coada trece prin aceleasi primitive, intr-un bloc completat cu zerouri: std::floor /
+		// std::nearbyint ar fi instantiate aici cu setul de instructiuni al fisierului.
+		if (i < count)
+		{
+			alignas(64) float tx[4 * LANES] = {};
+			alignas(64) float ts[4 * LANES];
+			alignas(64) float tc[4 * LANES];
+			memcpy(tx, x + i, (count - i) * sizeof(float));
+			SinCosBlock(tx, ts, tc);
+			memcpy(s + i, ts, (count - i) * sizeof(float));
+			memcpy(c + i, tc, (count - i) * sizeof(float));
+		}
+	}
+}
+
+namespace SIMD_KERNEL_NAMESPACE
+{
+	extern const SimdKernels kernels = {
+		MultiplyMat4Kernel,
+		QuatToMat4Kernel,
+		TransformPointsKernel,
+		TransformAabbsKernel,
+		SinCosKernel
+	};
+}
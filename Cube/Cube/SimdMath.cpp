@@ -0,0 +1,240 @@
+#include "SimdMath.h"
+#include "SimdKernels.h"
+
+#include <cmath>
+
+#if defined(SIMD_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#ifdef GLM_FORCE_QUAT_DATA_WXYZ
+#error "simd::QuatToMat4 expects glm::quat stored as x, y, z, w"
+#endif
+
+static_assert(sizeof(glm::mat4) == 16 * sizeof(float), "glm::mat4 must be 16 packed floats");
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "glm::vec3 must be 3 packed floats");
+static_assert(sizeof(glm::quat) == 4 * sizeof(float), "glm::quat must be 4 packed floats");
+static_assert(sizeof(simd::Aabb) == 6 * sizeof(float), "simd::Aabb must be 6 packed floats");
+
+namespace
+{
+	// Nivelul scalar foloseste glm direct si serveste drept referinta.
+	void MultiplyMat4Scalar(const float* a, size_t aStride, const float* b, float* out, size_t count)
+	{
+		const glm::mat4* matA = reinterpret_cast<const glm::mat4*>(a);
+		const glm::mat4* matB = reinterpret_cast<const glm::mat4*>(b);
+		glm::mat4* matOut = reinterpret_cast<glm::mat4*>(out);
+		if (aStride == 0)
+		{
+			const glm::mat4 shared = *matA;
+			for (size_t i = 0; i < count; ++i)
+			{
+				matOut[i] = shared * matB[i];
+			}
+			return;
+		}
+		for (size_t i = 0; i < count; ++i)
+		{
+			matOut[i] = matA[i] * matB[i];
+		}
+	}
+
+	void QuatToMat4Scalar(const float* q, float* out, size_t count)
+	{
+		const glm::quat* quats = reinterpret_cast<const glm::quat*>(q);
+		glm::mat4* matOut = reinterpret_cast<glm::mat4*>(out);
+		for (size_t i = 0; i < count; ++i)
+		{
+			matOut[i] = glm::mat4_cast(quats[i]);
+		}
+	}
+
+	void TransformPointsScalar(const float* m, const float* points, float* out, size_t count)
+	{
+		const glm::mat4& mat = *reinterpret_cast<const glm::mat4*>(m);
+		const glm::vec3* in = reinterpret_cast<const glm::vec3*>(points);
+		glm::vec3* vecOut = reinterpret_cast<glm::vec3*>(out);
+		for (size_t i = 0; i < count; ++i)
+		{
+			vecOut[i] = glm::vec3(mat * glm::vec4(in[i], 1.0f));
+		}
+	}
+
+	void TransformAabbsScalar(const float* m, const float* boxes, float* out, size_t count)
+	{
+		const glm::mat4& mat = *reinterpret_cast<const glm::mat4*>(m);
+		const simd::Aabb* in = reinterpret_cast<const simd::Aabb*>(boxes);
+		simd::Aabb* boxOut = reinterpret_cast<simd::Aabb*>(out);
+		for (size_t i = 0; i < count; ++i)
+		{
+			glm::vec3 center = (in[i].min + in[i].max) * 0.5f;
+			glm::vec3 extent = (in[i].max - in[i].min) * 0.5f;
+			glm::vec3 newCenter = glm::vec3(mat * glm::vec4(center, 1.0f));
+			glm::vec3 newExtent = glm::abs(glm::vec3(mat[0])) * extent.x + glm::abs(glm::vec3(mat[1])) * extent.y + glm::abs(glm::vec3(mat[2])) * extent.z;
+			boxOut[i].min = newCenter - newExtent;
+			boxOut[i].max = newCenter + newExtent;
+		}
+	}
+
+	void SinCosScalar(const float* x, float* s, float* c, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float value = x[i];
+			s[i] = sinf(value);
+			c[i] = cosf(value);
+		}
+	}
+
+	const SimdKernels scalarKernels = {
+		MultiplyMat4Scalar,
+		QuatToMat4Scalar,
+		TransformPointsScalar,
+		TransformAabbsScalar,
+		SinCosScalar
+	};
+
+	simd::ESimdLevel DetectLevel()
+	{
+#ifdef SIMD_X86
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		const int maxLeaf = info[0];
+
+		__cpuid(info, 1);
+		const bool bSse41 = (info[2] & (1 << 19)) != 0;
+		const bool bFma = (info[2] & (1 << 12)) != 0;
+		const bool bOsxsave = (info[2] & (1 << 27)) != 0;
+		const bool bAvx = (info[2] & (1 << 28)) != 0;
+
+		bool bAvx2 = false, bAvx512 = false;
+		if (maxLeaf >= 7 && bOsxsave && bAvx)
+		{
+			const unsigned long long xcr0 = _xgetbv(0);
+			const bool bYmmState = (xcr0 & 0x6) == 0x6;
+			const bool bZmmState = (xcr0 & 0xE6) == 0xE6;
+
+			__cpuidex(info, 7, 0);
+			bAvx2 = bYmmState && bFma && (info[1] & (1 << 5)) != 0;
+			bAvx512 = bZmmState && (info[1] & (1 << 16)) != 0;
+		}
+#else
+		__builtin_cpu_init();
+		const bool bSse41 = __builtin_cpu_supports("sse4.1");
+		const bool bAvx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+		const bool bAvx512 = __builtin_cpu_supports("avx512f");
+#endif
+		if (bAvx512)
+			return simd::SIMD_AVX512;
+		if (bAvx2)
+			return simd::SIMD_AVX2;
+		if (bSse41)
+			return simd::SIMD_SSE4;
+#endif
+		return simd::SIMD_SCALAR;
+	}
+
+	const SimdKernels* GetKernels(simd::ESimdLevel level)
+	{
+		switch (level)
+		{
+#ifdef SIMD_X86
+		case simd::SIMD_SSE4:
+			return &simd_sse4::kernels;
+		case simd::SIMD_AVX2:
+			return &simd_avx2::kernels;
+		case simd::SIMD_AVX512:
+			return &simd_avx512::kernels;
+#endif
+		default:
+			return &scalarKernels;
+		}
+	}
+
+	struct Dispatch
+	{
+		simd::ESimdLevel supported;
+		simd::ESimdLevel level;
+		const SimdKernels* kernels;
+
+		Dispatch()
+		{
+			supported = DetectLevel();
+			level = supported;
+			kernels = GetKernels(level);
+		}
+	};
+
+	Dispatch& GetDispatch()
+	{
+		static Dispatch dispatch;
+		return dispatch;
+	}
+}
+
+namespace simd
+{
+	ESimdLevel GetSupportedLevel()
+	{
+		return GetDispatch().supported;
+	}
+
+	ESimdLevel GetLevel()
+	{
+		return GetDispatch().level;
+	}
+
+	void SetLevel(ESimdLevel level)
+	{
+		Dispatch& dispatch = GetDispatch();
+		dispatch.level = level > dispatch.supported ? dispatch.supported : level;
+		dispatch.kernels = GetKernels(dispatch.level);
+	}
+
+	const char* GetLevelName(ESimdLevel level)
+	{
+		switch (level)
+		{
+		case SIMD_SCALAR:
+			return "scalar";
+		case SIMD_SSE4:
+			return "SSE4";
+		case SIMD_AVX2:
+			return "AVX2";
+		case SIMD_AVX512:
+			return "AVX-512";
+		}
+		return "unknown";
+	}
+
+	void MultiplyMat4(const glm::mat4* a, const glm::mat4* b, glm::mat4* out, size_t count)
+	{
+		GetDispatch().kernels->multiplyMat4(reinterpret_cast<const float*>(a), 16, reinterpret_cast<const float*>(b), reinterpret_cast<float*>(out), count);
+	}
+
+	void MultiplyMat4(const glm::mat4& a, const glm::mat4* b, glm::mat4* out, size_t count)
+	{
+		GetDispatch().kernels->multiplyMat4(&a[0][0], 0, reinterpret_cast<const float*>(b), reinterpret_cast<float*>(out), count);
+	}
+
+	void QuatToMat4(const glm::quat* q, glm::mat4* out, size_t count)
+	{
+		GetDispatch().kernels->quatToMat4(reinterpret_cast<const float*>(q), reinterpret_cast<float*>(out), count);
+	}
+
+	void TransformPoints(const glm::mat4& m, const glm::vec3* points, glm::vec3* out, size_t count)
+	{
+		GetDispatch().kernels->transformPoints(&m[0][0], reinterpret_cast<const float*>(points), reinterpret_cast<float*>(out), count);
+	}
+
+	void TransformAabbs(const glm::mat4& m, const Aabb* boxes, Aabb* out, size_t count)
+	{
+		GetDispatch().kernels->transformAabbs(&m[0][0], reinterpret_cast<const float*>(boxes), reinterpret_cast<float*>(out), count);
+	}
+
+	void SinCos(const float* x, float* s, float* c, size_t count)
+	{
+		GetDispatch().kernels->sinCos(x, s, c, count);
+	}
+}
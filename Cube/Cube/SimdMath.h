@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+
+#include <glm.hpp>
+#include <gtc/quaternion.hpp>
+
+// Rutine matematice pe loturi (arrays), cu implementare SSE4 / AVX2 / AVX-512
+// aleasa la rulare in functie de procesor. Datele sunt exact cele din glm
+// (mat4 coloana-major, quat in ordinea x, y, z, w), deci se pot folosi direct
+// pe vectori de glm::mat4 / glm::vec3 / glm::quat.
+namespace simd
+{
+	enum ESimdLevel
+	{
+		SIMD_SCALAR,
+		SIMD_SSE4,
+		SIMD_AVX2,
+		SIMD_AVX512
+	};
+
+	struct Aabb
+	{
+		glm::vec3 min;
+		glm::vec3 max;
+	};
+
+	// Cel mai bun nivel suportat de procesor si sistemul de operare.
+	ESimdLevel GetSupportedLevel();
+
+	ESimdLevel GetLevel();
+
+	// Fortarea unui nivel (benchmark-uri); nu poate depasi nivelul suportat.
+	void SetLevel(ESimdLevel level);
+
+	const char* GetLevelName(ESimdLevel level);
+
+	// out[i] = a[i] * b[i]
+	void MultiplyMat4(const glm::mat4* a, const glm::mat4* b, glm::mat4* out, size_t count);
+
+	// out[i] = a * b[i]
+	void MultiplyMat4(const glm::mat4& a, const glm::mat4* b, glm::mat4* out, size_t count);
+
+	// out[i] = glm::mat4_cast(q[i]); quaternionii trebuie sa fie normalizati
+	void QuatToMat4(const glm::quat* q, glm::mat4* out, size_t count);
+
+	// out[i] = vec3(m * vec4(points[i], 1))
+	void TransformPoints(const glm::mat4& m, const glm::vec3* points, glm::vec3* out, size_t count);
+
+	// AABB-ul transformarii afine m a fiecarei cutii (metoda lui Arvo)
+	void TransformAabbs(const glm::mat4& m, const Aabb* boxes, Aabb* out, size_t count);
+
+	// Aproximare polinomiala (eroare ~1e-7 pentru |x| < 8192); s sau c poate fi chiar x.
+	void SinCos(const float* x, float* s, float* c, size_t count);
+}
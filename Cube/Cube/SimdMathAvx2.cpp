@@ -0,0 +1,46 @@
+// Compilat cu AVX2 + FMA (-mavx2 -mfma, respectiv /arch:AVX2).
+#include "SimdKernels.h"
+
+#ifdef SIMD_X86
+
+#if !defined(__AVX2__) || (!defined(_MSC_VER) && !defined(__FMA__))
+#error "SimdMathAvx2.cpp must be compiled with AVX2 and FMA enabled (-mavx2 -mfma or /arch:AVX2)"
+#endif
+
+#include <immintrin.h>
+
+#define SIMD_KERNEL_NAMESPACE simd_avx2
+
+namespace
+{
+	typedef __m256 vfloat;
+	typedef __m256 vmask;
+
+	const int LANES = 2;
+
+	inline vfloat Set1(float value) { return _mm256_set1_ps(value); }
+	inline vfloat Add(vfloat a, vfloat b) { return _mm256_add_ps(a, b); }
+	inline vfloat Sub(vfloat a, vfloat b) { return _mm256_sub_ps(a, b); }
+	inline vfloat Mul(vfloat a, vfloat b) { return _mm256_mul_ps(a, b); }
+	inline vfloat MulAdd(vfloat a, vfloat b, vfloat c) { return _mm256_fmadd_ps(a, b, c); }
+	inline vfloat Abs(vfloat a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+	inline vfloat Round(vfloat a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+	inline vfloat Floor(vfloat a) { return _mm256_floor_ps(a); }
+	inline vmask GreaterThan(vfloat a, vfloat b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+	inline vfloat Select(vmask mask, vfloat a, vfloat b) { return _mm256_blendv_ps(b, a, mask); }
+	inline vfloat UnpackLo(vfloat a, vfloat b) { return _mm256_unpacklo_ps(a, b); }
+	inline vfloat UnpackHi(vfloat a, vfloat b) { return _mm256_unpackhi_ps(a, b); }
+	template <int imm> inline vfloat Shuffle(vfloat a, vfloat b) { return _mm256_shuffle_ps(a, b, imm); }
+	inline vfloat BlendW(vfloat xyz, vfloat w) { return _mm256_blend_ps(xyz, w, 0x88); }
+	inline vfloat BroadcastLane(const float* p) { return _mm256_broadcast_ps((const __m128*)p); }
+	inline vfloat Load(const float* p) { return _mm256_loadu_ps(p); }
+	inline void Store(float* p, vfloat a) { _mm256_storeu_ps(p, a); }
+	inline vfloat LoadLanes(const float* p, size_t stride)
+	{
+		return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p)), _mm_loadu_ps(p + stride), 1);
+	}
+}
+
+#include "SimdKernels.inl"
+
+#endif
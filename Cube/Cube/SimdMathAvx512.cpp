@@ -0,0 +1,49 @@
+// Compilat cu AVX-512F (-mavx512f, respectiv /arch:AVX512).
+#include "SimdKernels.h"
+
+#ifdef SIMD_X86
+
+#if !defined(__AVX512F__)
+#error "SimdMathAvx512.cpp must be compiled with AVX-512F enabled (-mavx512f or /arch:AVX512)"
+#endif
+
+#include <immintrin.h>
+
+#define SIMD_KERNEL_NAMESPACE simd_avx512
+
+namespace
+{
+	typedef __m512 vfloat;
+	typedef __mmask16 vmask;
+
+	const int LANES = 4;
+
+	inline vfloat Set1(float value) { return _mm512_set1_ps(value); }
+	inline vfloat Add(vfloat a, vfloat b) { return _mm512_add_ps(a, b); }
+	inline vfloat Sub(vfloat a, vfloat b) { return _mm512_sub_ps(a, b); }
+	inline vfloat Mul(vfloat a, vfloat b) { return _mm512_mul_ps(a, b); }
+	inline vfloat MulAdd(vfloat a, vfloat b, vfloat c) { return _mm512_fmadd_ps(a, b, c); }
+	inline vfloat Abs(vfloat a) { return _mm512_abs_ps(a); }
+	inline vfloat Round(vfloat a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+	inline vfloat Floor(vfloat a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+	inline vmask GreaterThan(vfloat a, vfloat b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+	inline vfloat Select(vmask mask, vfloat a, vfloat b) { return _mm512_mask_blend_ps(mask, b, a); }
+	inline vfloat UnpackLo(vfloat a, vfloat b) { return _mm512_unpacklo_ps(a, b); }
+	inline vfloat UnpackHi(vfloat a, vfloat b) { return _mm512_unpackhi_ps(a, b); }
+	template <int imm> inline vfloat Shuffle(vfloat a, vfloat b) { return _mm512_shuffle_ps(a, b, imm); }
+	inline vfloat BlendW(vfloat xyz, vfloat w) { return _mm512_mask_blend_ps(0x8888, xyz, w); }
+	inline vfloat BroadcastLane(const float* p) { return _mm512_broadcast_f32x4(_mm_loadu_ps(p)); }
+	inline vfloat Load(const float* p) { return _mm512_loadu_ps(p); }
+	inline void Store(float* p, vfloat a) { _mm512_storeu_ps(p, a); }
+	inline vfloat LoadLanes(const float* p, size_t stride)
+	{
+		vfloat v = _mm512_castps128_ps512(_mm_loadu_ps(p));
+		v = _mm512_insertf32x4(v, _mm_loadu_ps(p + stride), 1);
+		v = _mm512_insertf32x4(v, _mm_loadu_ps(p + 2 * stride), 2);
+		return _mm512_insertf32x4(v, _mm_loadu_ps(p + 3 * stride), 3);
+	}
+}
+
+#include "SimdKernels.inl"
+
+#endif
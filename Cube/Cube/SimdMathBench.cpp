@@ -0,0 +1,383 @@
+// Benchmark Google Benchmark pentru rutinele din SimdMath, comparate cu glm scalar.
+// Inainte de rulare se verifica eroarea maxima a fiecarui nivel SIMD fata de glm / std;
+// daca vreun nivel depaseste toleranta, programul iese cu codul 1 fara sa ruleze benchmark-urile.
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <glm.hpp>
+#include <gtc/matrix_transform.hpp>
+#include <gtc/quaternion.hpp>
+
+#include "SimdMath.h"
+
+namespace
+{
+	std::vector<glm::mat4> RandomMatrices(size_t count, unsigned int seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+		std::vector<glm::mat4> matrices(count);
+		for (glm::mat4& m : matrices)
+		{
+			for (int c = 0; c < 4; ++c)
+				m[c] = glm::vec4(dist(rng), dist(rng), dist(rng), dist(rng));
+		}
+		return matrices;
+	}
+
+	std::vector<glm::quat> RandomQuats(size_t count, unsigned int seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+		std::vector<glm::quat> quats(count);
+		for (glm::quat& q : quats)
+		{
+			q = glm::normalize(glm::quat(dist(rng), dist(rng), dist(rng), dist(rng)));
+		}
+		return quats;
+	}
+
+	std::vector<glm::vec3> RandomPoints(size_t count, unsigned int seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+		std::vector<glm::vec3> points(count);
+		for (glm::vec3& p : points)
+		{
+			p = glm::vec3(dist(rng), dist(rng), dist(rng));
+		}
+		return points;
+	}
+
+	std::vector<simd::Aabb> RandomBoxes(size_t count, unsigned int seed)
+	{
+		std::vector<glm::vec3> centers = RandomPoints(count, seed);
+		std::vector<simd::Aabb> boxes(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			boxes[i].min = centers[i] - glm::vec3(0.5f);
+			boxes[i].max = centers[i] + glm::vec3(0.5f);
+		}
+		return boxes;
+	}
+
+	std::vector<float> RandomAngles(size_t count, unsigned int seed, float range = 100.0f)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> dist(-range, range);
+		std::vector<float> angles(count);
+		for (float& a : angles)
+		{
+			a = dist(rng);
+		}
+		return angles;
+	}
+
+	glm::mat4 ModelMatrix()
+	{
+		glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(1.0f, -2.0f, 3.0f));
+		model = glm::rotate(model, glm::radians(30.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+		model = glm::rotate(model, glm::radians(45.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+		return glm::scale(model, glm::vec3(2.0f, 1.0f, 0.5f));
+	}
+
+	// Tolerante: eroare relativa (absoluta sub 1) pentru matrici si puncte, absoluta pentru sin / cos
+	// pe intreg domeniul documentat in SimdMath.h.
+	const float TRANSFORM_TOLERANCE = 1e-5f;
+	const float SINCOS_TOLERANCE = 2e-7f;
+	const float SINCOS_RANGE = 8192.0f;
+
+	float MaxError(const float* a, const float* b, size_t count)
+	{
+		float error = 0.0f;
+		for (size_t i = 0; i < count; ++i)
+		{
+			float diff = std::fabs(a[i] - b[i]);
+			if (diff > error)
+				error = diff;
+		}
+		return error;
+	}
+
+	// Fata de referinta b; valorile mai mici decat 1 se compara absolut.
+	float MaxRelativeError(const float* a, const float* b, size_t count)
+	{
+		float error = 0.0f;
+		for (size_t i = 0; i < count; ++i)
+		{
+			float diff = std::fabs(a[i] - b[i]) / std::fmax(std::fabs(b[i]), 1.0f);
+			if (diff > error)
+				error = diff;
+		}
+		return error;
+	}
+
+	bool CheckError(const char* level, const char* kernel, float error, float tolerance)
+	{
+		if (error <= tolerance)
+			return true;
+		printf("FAILED: %s %s error %g exceeds tolerance %g\n", level, kernel, error, tolerance);
+		return false;
+	}
+
+	bool CheckAccuracy()
+	{
+		const size_t count = 100003;
+		const std::vector<glm::mat4> a = RandomMatrices(count, 1);
+		const std::vector<glm::mat4> b = RandomMatrices(count, 2);
+		const std::vector<glm::quat> quats = RandomQuats(count, 3);
+		const std::vector<glm::vec3> points = RandomPoints(count, 4);
+		const std::vector<simd::Aabb> boxes = RandomBoxes(count, 5);
+		const std::vector<float> angles = RandomAngles(count, 6, SINCOS_RANGE);
+		const glm::mat4 model = ModelMatrix();
+
+		std::vector<glm::mat4> refMat(count), refQuat(count), outMat(count);
+		std::vector<glm::vec3> refPoints(count), outPoints(count);
+		std::vector<simd::Aabb> refBoxes(count), outBoxes(count);
+		std::vector<float> refSin(count), refCos(count), outSin(count), outCos(count);
+
+		simd::SetLevel(simd::SIMD_SCALAR);
+		simd::MultiplyMat4(a.data(), b.data(), refMat.data(), count);
+		simd::QuatToMat4(quats.data(), refQuat.data(), count);
+		simd::TransformPoints(model, points.data(), refPoints.data(), count);
+		simd::TransformAabbs(model, boxes.data(), refBoxes.data(), count);
+		simd::SinCos(angles.data(), refSin.data(), refCos.data(), count);
+
+		printf("level\tmat4_mul\tquat_to_mat4\tpoints\taabbs\tsin\tcos (max relative / abs error vs glm / std)\n");
+		bool bPassed = true;
+		for (int level = simd::SIMD_SSE4; level <= simd::GetSupportedLevel(); ++level)
+		{
+			simd::SetLevel((simd::ESimdLevel)level);
+			simd::MultiplyMat4(a.data(), b.data(), outMat.data(), count);
+			float errMat = MaxRelativeError(&outMat[0][0][0], &refMat[0][0][0], 16 * count);
+			simd::QuatToMat4(quats.data(), outMat.data(), count);
+			float errQuat = MaxRelativeError(&outMat[0][0][0], &refQuat[0][0][0], 16 * count);
+			simd::TransformPoints(model, points.data(), outPoints.data(), count);
+			float errPoints = MaxRelativeError(&outPoints[0][0], &refPoints[0][0], 3 * count);
+			simd::TransformAabbs(model, boxes.data(), outBoxes.data(), count);
+			float errBoxes = MaxRelativeError(&outBoxes[0].min[0], &refBoxes[0].min[0], 6 * count);
+			simd::SinCos(angles.data(), outSin.data(), outCos.data(), count);
+			float errSin = MaxError(refSin.data(), outSin.data(), count);
+			float errCos = MaxError(refCos.data(), outCos.data(), count);
+
+			const char* levelName = simd::GetLevelName((simd::ESimdLevel)level);
+			printf("%s\t%g\t%g\t%g\t%g\t%g\t%g\n", levelName, errMat, errQuat, errPoints, errBoxes, errSin, errCos);
+
+			bPassed &= CheckError(levelName, "mat4_mul", errMat, TRANSFORM_TOLERANCE);
+			bPassed &= CheckError(levelName, "quat_to_mat4", errQuat, TRANSFORM_TOLERANCE);
+			bPassed &= CheckError(levelName, "points", errPoints, TRANSFORM_TOLERANCE);
+			bPassed &= CheckError(levelName, "aabbs", errBoxes, TRANSFORM_TOLERANCE);
+			bPassed &= CheckError(levelName, "sin", errSin, SINCOS_TOLERANCE);
+			bPassed &= CheckError(levelName, "cos", errCos, SINCOS_TOLERANCE);
+		}
+		simd::SetLevel(simd::GetSupportedLevel());
+		return bPassed;
+	}
+
+	// Matricile ocupa 64 de octeti, asa ca rutinele pe matrici se opresc la 1M de elemente.
+	void MatrixSizes(benchmark::internal::Benchmark* b)
+	{
+		for (int level = simd::SIMD_SCALAR; level <= simd::GetSupportedLevel(); ++level)
+			for (long n = 1000; n <= 1000000; n *= 10)
+				b->Args({ level, n });
+	}
+
+	// Referintele glm nu depind de nivelul SIMD ales.
+	void GlmMatrixSizes(benchmark::internal::Benchmark* b)
+	{
+		for (long n = 1000; n <= 1000000; n *= 10)
+			b->Args({ n });
+	}
+
+	void GlmVectorSizes(benchmark::internal::Benchmark* b)
+	{
+		for (long n = 1000; n <= 10000000; n *= 10)
+			b->Args({ n });
+	}
+
+	void VectorSizes(benchmark::internal::Benchmark* b)
+	{
+		for (int level = simd::SIMD_SCALAR; level <= simd::GetSupportedLevel(); ++level)
+			for (long n = 1000; n <= 10000000; n *= 10)
+				b->Args({ level, n });
+	}
+
+	void SetBenchLevel(benchmark::State& state)
+	{
+		simd::SetLevel((simd::ESimdLevel)state.range(0));
+		state.SetLabel(simd::GetLevelName(simd::GetLevel()));
+	}
+
+	void BM_GlmMultiplyMat4(benchmark::State& state)
+	{
+		const size_t count = (size_t)state.range(0);
+		const std::vector<glm::mat4> a = RandomMatrices(count, 1);
+		const std::vector<glm::mat4> b = RandomMatrices(count, 2);
+		std::vector<glm::mat4> out(count);
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < count; ++i)
+				out[i] = a[i] * b[i];
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * count);
+	}
+
+	void BM_MultiplyMat4(benchmark::State& state)
+	{
+		SetBenchLevel(state);
+		const size_t count = (size_t)state.range(1);
+		const std::vector<glm::mat4> a = RandomMatrices(count, 1);
+		const std::vector<glm::mat4> b = RandomMatrices(count, 2);
+		std::vector<glm::mat4> out(count);
+		for (auto _ : state)
+		{
+			simd::MultiplyMat4(a.data(), b.data(), out.data(), count);
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * count);
+	}
+
+	void BM_GlmQuatToMat4(benchmark::State& state)
+	{
+		const size_t count = (size_t)state.range(0);
+		const std::vector<glm::quat> quats = RandomQuats(count, 3);
+		std::vector<glm::mat4> out(count);
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < count; ++i)
+				out[i] = glm::mat4_cast(quats[i]);
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * count);
+	}
+
+	void BM_QuatToMat4(benchmark::State& state)
+	{
+		SetBenchLevel(state);
+		const size_t count = (size_t)state.range(1);
+		const std::vector<glm::quat> quats = RandomQuats(count, 3);
+		std::vector<glm::mat4> out(count);
+		for (auto _ : state)
+		{
+			simd::QuatToMat4(quats.data(), out.data(), count);
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * count);
+	}
+
+	void BM_GlmTransformPoints(benchmark::State& state)
+	{
+		const size_t count = (size_t)state.range(0);
+		const std::vector<glm::vec3> points = RandomPoints(count, 4);
+		std::vector<glm::vec3> out(count);
+		const glm::mat4 model = ModelMatrix();
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < count; ++i)
+				out[i] = glm::vec3(model * glm::vec4(points[i], 1.0f));
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * count);
+	}
+
+	void BM_TransformPoints(benchmark::State& state)
+	{
+		SetBenchLevel(state);
+		const size_t count = (size_t)state.range(1);
+		const std::vector<glm::vec3> points = RandomPoints(count, 4);
+		std::vector<glm::vec3> out(count);
+		const glm::mat4 model = ModelMatrix();
+		for (auto _ : state)
+		{
+			simd::TransformPoints(model, points.data(), out.data(), count);
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * count);
+	}
+
+	void BM_TransformAabbs(benchmark::State& state)
+	{
+		SetBenchLevel(state);
+		const size_t count = (size_t)state.range(1);
+		const std::vector<simd::Aabb> boxes = RandomBoxes(count, 5);
+		std::vector<simd::Aabb> out(count);
+		const glm::mat4 model = ModelMatrix();
+		for (auto _ : state)
+		{
+			simd::TransformAabbs(model, boxes.data(), out.data(), count);
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * count);
+	}
+
+	void BM_StdSinCos(benchmark::State& state)
+	{
+		const size_t count = (size_t)state.range(0);
+		const std::vector<float> angles = RandomAngles(count, 6);
+		std::vector<float> s(count), c(count);
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				s[i] = glm::sin(angles[i]);
+				c[i] = glm::cos(angles[i]);
+			}
+			benchmark::DoNotOptimize(s.data());
+			benchmark::DoNotOptimize(c.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * count);
+	}
+
+	void BM_SinCos(benchmark::State& state)
+	{
+		SetBenchLevel(state);
+		const size_t count = (size_t)state.range(1);
+		const std::vector<float> angles = RandomAngles(count, 6);
+		std::vector<float> s(count), c(count);
+		for (auto _ : state)
+		{
+			simd::SinCos(angles.data(), s.data(), c.data(), count);
+			benchmark::DoNotOptimize(s.data());
+			benchmark::DoNotOptimize(c.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * count);
+	}
+}
+
+BENCHMARK(BM_GlmMultiplyMat4)->Apply(GlmMatrixSizes);
+BENCHMARK(BM_MultiplyMat4)->Apply(MatrixSizes);
+BENCHMARK(BM_GlmQuatToMat4)->Apply(GlmMatrixSizes);
+BENCHMARK(BM_QuatToMat4)->Apply(MatrixSizes);
+BENCHMARK(BM_GlmTransformPoints)->Apply(GlmVectorSizes);
+BENCHMARK(BM_TransformPoints)->Apply(VectorSizes);
+BENCHMARK(BM_TransformAabbs)->Apply(VectorSizes);
+BENCHMARK(BM_StdSinCos)->Apply(GlmVectorSizes);
+BENCHMARK(BM_SinCos)->Apply(VectorSizes);
+
+int main(int argc, char** argv)
+{
+	if (!CheckAccuracy())
+		return 1;
+
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv))
+		return 1;
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
@@ -0,0 +1,43 @@
+// Compilat cu SSE4.1 (-msse4.1); pe MSVC x64 instructiunile sunt disponibile implicit.
+#include "SimdKernels.h"
+
+#ifdef SIMD_X86
+
+#if !defined(_MSC_VER) && !defined(__SSE4_1__)
+#error "SimdMathSse4.cpp must be compiled with SSE4.1 enabled (-msse4.1)"
+#endif
+
+#include <smmintrin.h>
+
+#define SIMD_KERNEL_NAMESPACE simd_sse4
+
+namespace
+{
+	typedef __m128 vfloat;
+	typedef __m128 vmask;
+
+	const int LANES = 1;
+
+	inline vfloat Set1(float value) { return _mm_set1_ps(value); }
+	inline vfloat Add(vfloat a, vfloat b) { return _mm_add_ps(a, b); }
+	inline vfloat Sub(vfloat a, vfloat b) { return _mm_sub_ps(a, b); }
+	inline vfloat Mul(vfloat a, vfloat b) { return _mm_mul_ps(a, b); }
+	inline vfloat MulAdd(vfloat a, vfloat b, vfloat c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+	inline vfloat Abs(vfloat a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+	inline vfloat Round(vfloat a) { return _mm_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+	inline vfloat Floor(vfloat a) { return _mm_floor_ps(a); }
+	inline vmask GreaterThan(vfloat a, vfloat b) { return _mm_cmpgt_ps(a, b); }
+	inline vfloat Select(vmask mask, vfloat a, vfloat b) { return _mm_blendv_ps(b, a, mask); }
+	inline vfloat UnpackLo(vfloat a, vfloat b) { return _mm_unpacklo_ps(a, b); }
+	inline vfloat UnpackHi(vfloat a, vfloat b) { return _mm_unpackhi_ps(a, b); }
+	template <int imm> inline vfloat Shuffle(vfloat a, vfloat b) { return _mm_shuffle_ps(a, b, imm); }
+	inline vfloat BlendW(vfloat xyz, vfloat w) { return _mm_blend_ps(xyz, w, 0x8); }
+	inline vfloat BroadcastLane(const float* p) { return _mm_loadu_ps(p); }
+	inline vfloat Load(const float* p) { return _mm_loadu_ps(p); }
+	inline void Store(float* p, vfloat a) { _mm_storeu_ps(p, a); }
+	inline vfloat LoadLanes(const float* p, size_t) { return _mm_loadu_ps(p); }
+}
+
+#include "SimdKernels.inl"
+
+#endif
@@ -0,0 +1,342 @@
+#pragma once
+
+#include <cmath>
+
+#include <GL/glew.h>
+#include <glm.hpp>
+
+#include "Shader.h"
+#include "GpuMemory.h"
+#include "FramePacer.h"
+
+// Distributia unei fractiuni masurate pe cadru (0..1): media si minimul prin RunningStats,
+// percentilele dintr-o histograma cu pasul 0.1%, ca memoria sa nu creasca odata cu rularea.
+struct FractionStats
+{
+	static const int HISTOGRAM_BINS = 1000;
+
+	RunningStats stats;
+	unsigned int histogram[HISTOGRAM_BINS + 1] = {};
+
+	void Add(float value)
+	{
+		stats.Add(value);
+		++histogram[(int)std::lround(glm::clamp(value, 0.0f, 1.0f) * HISTOGRAM_BINS)];
+	}
+
+	float Percentile(double p) const
+	{
+		const unsigned int rank = (unsigned int)std::ceil(p * stats.samples);
+		unsigned int count = 0;
+		for (int bin = 0; bin <= HISTOGRAM_BINS; ++bin)
+		{
+			count += histogram[bin];
+			if (count >= rank && count > 0)
+				return (float)bin / HISTOGRAM_BINS;
+		}
+		return 0.0f;
+	}
+};
+
+// Cache temporal pentru termenul scump al iluminarii (difuza luminii principale si suma
+// luminilor de umplere din CachedPhongLight.fs). Geometria opaca iluminata se deseneaza in
+// tintele cache-ului; fiecare pixel se reproiecteaza in cadrul anterior cu matricea
+// view-projection (si model) de atunci, iar daca adancimea si pozitia luminii in spatiul
+// obiectului se potrivesc in toleranta, termenul este refolosit din istoric in loc sa fie recalculat.
+//
+// Tinte (cate doua seturi de istoric, alternate intre cadre):
+//   0: culoarea finala RGBA8, copiata la End in framebuffer-ul scenei impreuna cu adancimea
+//   1: termenul cache-uit si normala impachetata in alpha (RGBA16F)
+//   2: cheia: pozitia luminii folosita la calcul si adancimea liniara (RGBA32F)
+//   3: (acoperit, refolosit) pe pixel, mediat prin mipmap pentru rata de reutilizare
+// Framebuffer-ul scenei trebuie sa aiba depth GL_DEPTH24_STENCIL8, ca la TransparencyRenderer.
+class TemporalCache
+{
+public:
+	static const int HISTORY_TEXTURE_UNIT = 4;
+
+	TemporalCache(float depthTolerance = 0.01f, float lightTolerance = 0.02f)
+		: depthTolerance(depthTolerance), lightTolerance(lightTolerance)
+	{
+		glGenBuffers(STATS_LATENCY, statsPBO);
+		for (int i = 0; i < STATS_LATENCY; ++i)
+		{
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, statsPBO[i]);
+			GpuBufferData(GL_PIXEL_PACK_BUFFER, statsPBO[i], 2 * sizeof(float), NULL, GL_STREAM_READ);
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	}
+
+	~TemporalCache()
+	{
+		DeleteTargets();
+		GpuDeleteBuffers(STATS_LATENCY, statsPBO);
+	}
+
+	bool IsEnabled() const
+	{
+		return bEnabled;
+	}
+
+	// Dezactivat, fiecare pixel este recalculat (acelasi shader si aceleasi tinte), pentru comparatie.
+	void SetEnabled(bool bEnabled)
+	{
+		this->bEnabled = bEnabled;
+	}
+
+	// Fractiunea pixelilor acoperiti de geometrie care au refolosit istoricul; masurata
+	// cu o intarziere de STATS_LATENCY cadre, ca citirea sa nu astepte dupa GPU.
+	float GetHitRate() const
+	{
+		return lastHitRate;
+	}
+
+	float GetCoverage() const
+	{
+		return lastCoverage;
+	}
+
+	// Distributia pe cadre a ratei de reutilizare si a acoperirii de la ultimul ResetStats.
+	const FractionStats& GetHitRateStats() const
+	{
+		return hitRateStats;
+	}
+
+	const FractionStats& GetCoverageStats() const
+	{
+		return coverageStats;
+	}
+
+	void ResetStats()
+	{
+		hitRateStats = FractionStats();
+		coverageStats = FractionStats();
+	}
+
+	// Leaga tintele cache-ului in locul framebuffer-ului legat acum. lightingState contine
+	// parametrii care intra in termenul cache-uit fara sa faca parte din cheie; schimbarea
+	// lor invalideaza tot istoricul.
+	void Begin(const glm::mat4& viewProjection, const glm::vec4& lightingState)
+	{
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		GLint framebuffer = 0;
+		glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &framebuffer);
+		sceneFramebuffer = (unsigned int)framebuffer;
+
+		EnsureTargets(viewport[2], viewport[3]);
+		if (lightingState != previousLightingState)
+			bHistoryValid = false;
+		previousLightingState = lightingState;
+		currentViewProjection = viewProjection;
+
+		const int write = frameIndex % 2;
+		const int read = 1 - write;
+		glBindFramebuffer(GL_FRAMEBUFFER, cacheFBO[write]);
+		const GLenum drawBuffers[4] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3 };
+		glDrawBuffers(4, drawBuffers);
+
+		// culoarea de fundal este cea a scenei; restul tintelor pornesc de la "fara geometrie"
+		float clearColor[4];
+		glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+		const float zero[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		glClearBufferfv(GL_COLOR, 0, clearColor);
+		glClearBufferfv(GL_COLOR, 1, zero);
+		glClearBufferfv(GL_COLOR, 2, zero);
+		glClearBufferfv(GL_COLOR, 3, zero);
+		glClear(GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+		glActiveTexture(GL_TEXTURE0 + HISTORY_TEXTURE_UNIT);
+		glBindTexture(GL_TEXTURE_2D, irradianceTexture[read]);
+		glActiveTexture(GL_TEXTURE0 + HISTORY_TEXTURE_UNIT + 1);
+		glBindTexture(GL_TEXTURE_2D, keyTexture[read]);
+		glActiveTexture(GL_TEXTURE0);
+	}
+
+	// Uniformele de istoric pentru un program cu CachedPhongLight.fs; programul devine activ.
+	// lightKey = pozitia luminii principale in spatiul obiectului (lightPos pentru geometria
+	// statica); pentru obiectele in miscare, apelantul seteaza si prevModel.
+	void Bind(const Shader& shader, const glm::vec3& lightKey) const
+	{
+		shader.Use();
+		shader.SetVec3("lightKey", lightKey);
+		shader.SetInt("historyIrradiance", HISTORY_TEXTURE_UNIT);
+		shader.SetInt("historyKey", HISTORY_TEXTURE_UNIT + 1);
+		shader.SetInt("reuseHistory", bEnabled && bHistoryValid);
+		shader.SetFloat("depthTolerance", depthTolerance);
+		shader.SetFloat("lightTolerance", lightTolerance);
+		shader.SetMat4("prevViewProjection", previousViewProjection);
+	}
+
+	// Copiaza culoarea si adancimea in framebuffer-ul scenei si porneste citirea statisticilor.
+	void End()
+	{
+		const int write = frameIndex % 2;
+
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, cacheFBO[write]);
+		glReadBuffer(GL_COLOR_ATTACHMENT0);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, sceneFramebuffer);
+		glBlitFramebuffer(0, 0, targetWidth, targetHeight, 0, 0, targetWidth, targetHeight,
+			GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+		glBindFramebuffer(GL_FRAMEBUFFER, sceneFramebuffer);
+
+		ReadStats();
+
+		glActiveTexture(GL_TEXTURE0 + HISTORY_TEXTURE_UNIT);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glActiveTexture(GL_TEXTURE0 + HISTORY_TEXTURE_UNIT + 1);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glActiveTexture(GL_TEXTURE0);
+
+		previousViewProjection = currentViewProjection;
+		bHistoryValid = true;
+		++frameIndex;
+	}
+
+private:
+	static const int STATS_LATENCY = 3;
+
+	// Media tintei de statistici pe nivelul 1x1 al mipmap-ului, copiata intr-un PBO; PBO-ul
+	// scris acum STATS_LATENCY cadre in urma este deja disponibil si se citeste fara blocare.
+	void ReadStats()
+	{
+		glBindTexture(GL_TEXTURE_2D, statsTexture);
+		glGenerateMipmap(GL_TEXTURE_2D);
+
+		const int slot = frameIndex % STATS_LATENCY;
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, statsPBO[slot]);
+		if (statsPending[slot])
+		{
+			const float* pStats = (const float*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, 2 * sizeof(float), GL_MAP_READ_BIT);
+			if (pStats)
+			{
+				lastCoverage = pStats[0];
+				lastHitRate = pStats[0] > 0.0f ? pStats[1] / pStats[0] : 0.0f;
+				hitRateStats.Add(lastHitRate);
+				coverageStats.Add(lastCoverage);
+				glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+			}
+		}
+		glGetTexImage(GL_TEXTURE_2D, statsTopLevel, GL_RG, GL_FLOAT, (void*)0);
+		statsPending[slot] = true;
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	void EnsureTargets(int width, int height)
+	{
+		if (cacheFBO[0] && width == targetWidth && height == targetHeight)
+			return;
+
+		DeleteTargets();
+		targetWidth = width;
+		targetHeight = height;
+		bHistoryValid = false;
+
+		colorRenderbuffer = CreateRenderbuffer(GL_RGBA8);
+		depthRenderbuffer = CreateRenderbuffer(GL_DEPTH24_STENCIL8);
+
+		statsTexture = CreateTargetTexture(GL_RG16F, GL_RG);
+		glBindTexture(GL_TEXTURE_2D, statsTexture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
+		glGenerateMipmap(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		GetGpuMemoryTracker().Set(EGpuResourceType::GPU_TEXTURE, statsTexture, GetTextureTexels(width, height, true) * GetTexelBytes(GL_RG16F));
+		statsTopLevel = (int)std::floor(std::log2((float)(width > height ? width : height)));
+
+		for (int i = 0; i < 2; ++i)
+		{
+			irradianceTexture[i] = CreateTargetTexture(GL_RGBA16F, GL_RGBA);
+			keyTexture[i] = CreateTargetTexture(GL_RGBA32F, GL_RGBA);
+
+			glGenFramebuffers(1, &cacheFBO[i]);
+			glBindFramebuffer(GL_FRAMEBUFFER, cacheFBO[i]);
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRenderbuffer);
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, irradianceTexture[i], 0);
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, GL_TEXTURE_2D, keyTexture[i], 0);
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT3, GL_TEXTURE_2D, statsTexture, 0);
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRenderbuffer);
+
+			if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			{
+				std::cout << "ERROR::FRAMEBUFFER:: Temporal cache framebuffer is not complete!" << std::endl;
+			}
+		}
+		glBindFramebuffer(GL_FRAMEBUFFER, sceneFramebuffer);
+	}
+
+	unsigned int CreateRenderbuffer(GLenum internalFormat) const
+	{
+		unsigned int renderbuffer;
+		glGenRenderbuffers(1, &renderbuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+		GpuRenderbufferStorage(renderbuffer, internalFormat, targetWidth, targetHeight);
+		glBindRenderbuffer(GL_RENDERBUFFER, 0);
+		return renderbuffer;
+	}
+
+	unsigned int CreateTargetTexture(GLint internalFormat, GLenum format) const
+	{
+		unsigned int texture;
+		glGenTextures(1, &texture);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		GpuTexImage2D(texture, internalFormat, targetWidth, targetHeight, format, GL_FLOAT, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		return texture;
+	}
+
+	void DeleteTargets()
+	{
+		if (cacheFBO[0])
+		{
+			glDeleteFramebuffers(2, cacheFBO);
+			GpuDeleteTextures(2, irradianceTexture);
+			GpuDeleteTextures(2, keyTexture);
+			GpuDeleteTextures(1, &statsTexture);
+			GpuDeleteRenderbuffers(1, &colorRenderbuffer);
+			GpuDeleteRenderbuffers(1, &depthRenderbuffer);
+		}
+		for (int i = 0; i < 2; ++i)
+			cacheFBO[i] = irradianceTexture[i] = keyTexture[i] = 0;
+		statsTexture = colorRenderbuffer = depthRenderbuffer = 0;
+		targetWidth = targetHeight = 0;
+
+		// statisticile in curs se refera la tintele vechi
+		for (int i = 0; i < STATS_LATENCY; ++i)
+			statsPending[i] = false;
+	}
+
+private:
+	float depthTolerance;
+	float lightTolerance;
+	bool bEnabled = true;
+	bool bHistoryValid = false;
+	unsigned int frameIndex = 0;
+	unsigned int sceneFramebuffer = 0;
+
+	glm::mat4 currentViewProjection = glm::mat4(1.0f);
+	glm::mat4 previousViewProjection = glm::mat4(1.0f);
+	glm::vec4 previousLightingState = glm::vec4(0.0f);
+
+	unsigned int cacheFBO[2] = { 0, 0 };
+	unsigned int irradianceTexture[2] = { 0, 0 };
+	unsigned int keyTexture[2] = { 0, 0 };
+	unsigned int statsTexture = 0;
+	unsigned int colorRenderbuffer = 0;
+	unsigned int depthRenderbuffer = 0;
+	int targetWidth = 0;
+	int targetHeight = 0;
+	int statsTopLevel = 0;
+
+	unsigned int statsPBO[STATS_LATENCY];
+	bool statsPending[STATS_LATENCY] = {};
+	float lastHitRate = 0.0f;
+	float lastCoverage = 0.0f;
+	FractionStats hitRateStats;
+	FractionStats coverageStats;
+};
@@ -0,0 +1,16 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 Normal;
+in vec3 FragPos;
+in vec3 objectColor;
+
+#include "PhongShading.glsl"
+
+uniform float alpha = 0.25;
+
+// blending clasic; instantele vin sortate de la spate la fata
+void main()
+{
+    FragColor = vec4(Shade(), alpha);
+}
@@ -0,0 +1,375 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "Shader.h"
+#include "GpuMemory.h"
+
+enum ETransparencyMode
+{
+	TRANSPARENCY_OFF,
+	TRANSPARENCY_SORTED,
+	TRANSPARENCY_WEIGHTED,
+	TRANSPARENCY_LINKED_LIST
+};
+
+inline const char* GetTransparencyModeName(ETransparencyMode mode)
+{
+	switch (mode)
+	{
+	case ETransparencyMode::TRANSPARENCY_OFF:
+		return "off";
+	case ETransparencyMode::TRANSPARENCY_SORTED:
+		return "sorted";
+	case ETransparencyMode::TRANSPARENCY_WEIGHTED:
+		return "weighted blended OIT";
+	case ETransparencyMode::TRANSPARENCY_LINKED_LIST:
+		return "per-pixel linked lists";
+	}
+	return "unknown";
+}
+
+// Trecerea transparenta pentru campul de cuburi, desenata dupa geometria opaca.
+//  - SORTED: blending clasic; instantele trebuie sa vina sortate de la spate la fata (InstanceCuller::CullSorted).
+//  - WEIGHTED: weighted blended OIT, intr-o singura trecere fara sortare, urmata de compunerea peste scena;
+//    rezultatul este aproximativ, dar costul nu depinde de ordinea sau numarul straturilor.
+//  - LINKED_LIST: cate o lista inlantuita de fragmente pe pixel (GL 4.3), sortata la compunere;
+//    exact pana la 32 de straturi pe pixel, cat timp bufferul de noduri nu se umple. Fragmentele
+//    pierdute in ambele cazuri se numara (ReadDroppedFragments, ReadTruncatedFragments).
+// Adancimea opaca este copiata din framebuffer-ul scenei, deci acesta trebuie sa aiba depth GL_DEPTH24_STENCIL8.
+class TransparencyRenderer
+{
+public:
+	// averageLayers dimensioneaza bufferul de noduri al listelor (straturi medii pe pixel)
+	explicit TransparencyRenderer(int averageLayers = 4)
+	{
+		Init(averageLayers);
+	}
+
+	~TransparencyRenderer()
+	{
+		DeleteTargets();
+		DeleteLinkedListStorage();
+		glDeleteVertexArrays(1, &fullscreenVAO);
+	}
+
+	bool IsSupported(ETransparencyMode mode) const
+	{
+		if (mode == ETransparencyMode::TRANSPARENCY_LINKED_LIST)
+			return hasLinkedList;
+		return true;
+	}
+
+	// Pregateste trecerea transparenta peste framebuffer-ul legat acum (fereastra sau tinta scenei)
+	// si intoarce programul cu care se deseneaza geometria; apelantul seteaza uniformele si desenul.
+	const Shader& Begin(ETransparencyMode mode)
+	{
+		if (mode == ETransparencyMode::TRANSPARENCY_OFF || !IsSupported(mode))
+			mode = ETransparencyMode::TRANSPARENCY_WEIGHTED;
+		activeMode = mode;
+
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		GLint framebuffer = 0;
+		glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &framebuffer);
+		sceneFramebuffer = (unsigned int)framebuffer;
+
+		glDepthMask(GL_FALSE);
+		glEnable(GL_BLEND);
+
+		if (mode == ETransparencyMode::TRANSPARENCY_SORTED)
+		{
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+			sortedShader->Use();
+			return *sortedShader;
+		}
+
+		EnsureTargets(viewport[2], viewport[3]);
+
+		// transparentele sunt testate fata de adancimea geometriei opace
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, sceneFramebuffer);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, oitFBO);
+		glBlitFramebuffer(0, 0, targetWidth, targetHeight, 0, 0, targetWidth, targetHeight, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+		glBindFramebuffer(GL_FRAMEBUFFER, oitFBO);
+
+		if (mode == ETransparencyMode::TRANSPARENCY_WEIGHTED)
+		{
+			const GLenum drawBuffers[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+			glDrawBuffers(2, drawBuffers);
+
+			const float accumClear[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+			const float weightClear[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			glClearBufferfv(GL_COLOR, 0, accumClear);
+			glClearBufferfv(GL_COLOR, 1, weightClear);
+
+			// culori si ponderi adunate, revealage inmultit cu (1 - alpha)
+			glBlendFuncSeparate(GL_ONE, GL_ONE, GL_ZERO, GL_ONE_MINUS_SRC_ALPHA);
+			accumulateShader->Use();
+			return *accumulateShader;
+		}
+
+		EnsureLinkedListStorage(targetWidth, targetHeight);
+
+		// fragmentele ajung doar in liste, nu in tintele de culoare
+		glDrawBuffer(GL_NONE);
+		glDisable(GL_BLEND);
+
+		const GLuint zero[LIST_COUNTER_COUNT] = {};
+		glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, counterBuffer);
+		glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, 0, sizeof(zero), zero);
+		glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, headClearPBO);
+		glBindTexture(GL_TEXTURE_2D, headTexture);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, targetWidth, targetHeight, GL_RED_INTEGER, GL_UNSIGNED_INT, (void*)0);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		glBindImageTexture(0, headTexture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32UI);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, nodeBuffer);
+		glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, counterBuffer);
+
+		linkedListShader->Use();
+		linkedListShader->SetUInt("maxNodes", nodeCapacity);
+		return *linkedListShader;
+	}
+
+	// Compune rezultatul peste framebuffer-ul scenei si reface starea de desenare opaca.
+	void End()
+	{
+		if (activeMode == ETransparencyMode::TRANSPARENCY_WEIGHTED)
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, sceneFramebuffer);
+			glDisable(GL_DEPTH_TEST);
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+			compositeShader->Use();
+			compositeShader->SetInt("accumTexture", 0);
+			compositeShader->SetInt("weightTexture", 1);
+			glActiveTexture(GL_TEXTURE0);
+			glBindTexture(GL_TEXTURE_2D, accumTexture);
+			glActiveTexture(GL_TEXTURE1);
+			glBindTexture(GL_TEXTURE_2D, weightTexture);
+
+			glBindVertexArray(fullscreenVAO);
+			glDrawArrays(GL_TRIANGLES, 0, 3);
+
+			glBindTexture(GL_TEXTURE_2D, 0);
+			glActiveTexture(GL_TEXTURE0);
+			glBindTexture(GL_TEXTURE_2D, 0);
+		}
+		else if (activeMode == ETransparencyMode::TRANSPARENCY_LINKED_LIST)
+		{
+			glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+
+			glBindFramebuffer(GL_FRAMEBUFFER, sceneFramebuffer);
+			glDisable(GL_DEPTH_TEST);
+			glEnable(GL_BLEND);
+			glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+			resolveShader->Use();
+			glBindVertexArray(fullscreenVAO);
+			glDrawArrays(GL_TRIANGLES, 0, 3);
+
+			// urmatorul cadru reseteaza capetele de lista si contoarele prin copieri, dupa scrierile din shader
+			glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+		}
+
+		glBindVertexArray(0);
+		glEnable(GL_DEPTH_TEST);
+		glDisable(GL_BLEND);
+		glBlendFunc(GL_ONE, GL_ZERO);
+		glDepthMask(GL_TRUE);
+	}
+
+	// Fragmentele pierdute in ultima trecere cu liste din lipsa de noduri (citire sincrona).
+	unsigned int ReadDroppedFragments() const
+	{
+		const GLuint fragmentCount = ReadListCounter(LIST_COUNTER_NODES);
+		return fragmentCount > nodeCapacity ? fragmentCount - nodeCapacity : 0;
+	}
+
+	// Fragmentele memorate, dar lasate afara la compunere pentru ca pixelul avea peste 32 de straturi.
+	unsigned int ReadTruncatedFragments() const
+	{
+		return ReadListCounter(LIST_COUNTER_TRUNCATED);
+	}
+
+private:
+	// contoarele listelor, in ordinea offset-urilor atomic_uint din OitLinkedList.fs si OitResolve.fs
+	enum EListCounter
+	{
+		LIST_COUNTER_NODES,
+		LIST_COUNTER_TRUNCATED,
+		LIST_COUNTER_COUNT
+	};
+
+	GLuint ReadListCounter(EListCounter counter) const
+	{
+		if (!counterBuffer)
+			return 0;
+
+		GLuint value = 0;
+		glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, counterBuffer);
+		glGetBufferSubData(GL_ATOMIC_COUNTER_BUFFER, counter * sizeof(GLuint), sizeof(value), &value);
+		glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
+		return value;
+	}
+
+	void Init(int averageLayers)
+	{
+		this->averageLayers = averageLayers > 0 ? averageLayers : 1;
+		hasLinkedList = GLEW_VERSION_4_3 ||
+			(GLEW_ARB_shader_image_load_store && GLEW_ARB_shader_storage_buffer_object && GLEW_ARB_shader_atomic_counters);
+
+		// VAO gol pentru triunghiul de ecran complet, generat din gl_VertexID
+		glGenVertexArrays(1, &fullscreenVAO);
+
+		sortedShader.reset(new Shader("CubeField.vs", "TranslucentField.fs"));
+		accumulateShader.reset(new Shader("CubeField.vs", "OitAccumulate.fs"));
+		compositeShader.reset(new Shader("Fullscreen.vs", "OitComposite.fs"));
+		if (hasLinkedList)
+		{
+			linkedListShader.reset(new Shader("CubeField.vs", "OitLinkedList.fs"));
+			resolveShader.reset(new Shader("Fullscreen.vs", "OitResolve.fs"));
+		}
+	}
+
+	void EnsureTargets(int width, int height)
+	{
+		if (oitFBO && width == targetWidth && height == targetHeight)
+			return;
+
+		DeleteTargets();
+		targetWidth = width;
+		targetHeight = height;
+
+		glGenFramebuffers(1, &oitFBO);
+		glBindFramebuffer(GL_FRAMEBUFFER, oitFBO);
+
+		// 32 de biti: intr-un volum dens suma ponderilor depaseste usor domeniul half-float
+		accumTexture = CreateTargetTexture(GL_RGBA32F, GL_RGBA);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, accumTexture, 0);
+		weightTexture = CreateTargetTexture(GL_R32F, GL_RED);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, weightTexture, 0);
+
+		glGenRenderbuffers(1, &depthRenderbuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, depthRenderbuffer);
+		GpuRenderbufferStorage(depthRenderbuffer, GL_DEPTH24_STENCIL8, width, height);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRenderbuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			std::cout << "ERROR::FRAMEBUFFER:: Transparency framebuffer is not complete!" << std::endl;
+		}
+		glBindFramebuffer(GL_FRAMEBUFFER, sceneFramebuffer);
+	}
+
+	unsigned int CreateTargetTexture(GLint internalFormat, GLenum format) const
+	{
+		unsigned int texture;
+		glGenTextures(1, &texture);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		GpuTexImage2D(texture, internalFormat, targetWidth, targetHeight, format, GL_FLOAT, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		return texture;
+	}
+
+	void DeleteTargets()
+	{
+		if (oitFBO)
+		{
+			glDeleteFramebuffers(1, &oitFBO);
+			GpuDeleteTextures(1, &accumTexture);
+			GpuDeleteTextures(1, &weightTexture);
+			GpuDeleteRenderbuffers(1, &depthRenderbuffer);
+		}
+		oitFBO = accumTexture = weightTexture = depthRenderbuffer = 0;
+		targetWidth = targetHeight = 0;
+	}
+
+	void EnsureLinkedListStorage(int width, int height)
+	{
+		if (headTexture && width == listWidth && height == listHeight)
+			return;
+
+		DeleteLinkedListStorage();
+		listWidth = width;
+		listHeight = height;
+		nodeCapacity = (unsigned int)(width * height * averageLayers);
+
+		glGenTextures(1, &headTexture);
+		glBindTexture(GL_TEXTURE_2D, headTexture);
+		GpuTexImage2D(headTexture, GL_R32UI, width, height, GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		// sursa pentru resetarea capetelor de lista la "lista goala" in fiecare cadru
+		const std::vector<GLuint> endOfList((size_t)width * height, 0xFFFFFFFFu);
+		glGenBuffers(1, &headClearPBO);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, headClearPBO);
+		GpuBufferData(GL_PIXEL_UNPACK_BUFFER, headClearPBO, endOfList.size() * sizeof(GLuint), endOfList.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		// noduri uvec4: culoare RGBA8, adancime, urmatorul nod, neutilizat
+		glGenBuffers(1, &nodeBuffer);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, nodeBuffer);
+		GpuBufferData(GL_SHADER_STORAGE_BUFFER, nodeBuffer, (GLsizeiptr)nodeCapacity * 4 * sizeof(GLuint), NULL, GL_DYNAMIC_COPY);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+		glGenBuffers(1, &counterBuffer);
+		glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, counterBuffer);
+		// doua atomic_uint: contorul de noduri (OitLinkedList.fs) si contorul trunchierilor (OitResolve.fs)
+		GpuBufferData(GL_ATOMIC_COUNTER_BUFFER, counterBuffer, LIST_COUNTER_COUNT * sizeof(GLuint), NULL, GL_DYNAMIC_COPY);
+		glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
+	}
+
+	void DeleteLinkedListStorage()
+	{
+		if (headTexture)
+		{
+			GpuDeleteTextures(1, &headTexture);
+			GpuDeleteBuffers(1, &headClearPBO);
+			GpuDeleteBuffers(1, &nodeBuffer);
+			GpuDeleteBuffers(1, &counterBuffer);
+		}
+		headTexture = headClearPBO = nodeBuffer = counterBuffer = 0;
+		listWidth = listHeight = 0;
+		nodeCapacity = 0;
+	}
+
+private:
+	int averageLayers;
+	bool hasLinkedList;
+	ETransparencyMode activeMode = ETransparencyMode::TRANSPARENCY_OFF;
+	unsigned int sceneFramebuffer = 0;
+	unsigned int fullscreenVAO = 0;
+
+	unsigned int oitFBO = 0;
+	unsigned int accumTexture = 0;
+	unsigned int weightTexture = 0;
+	unsigned int depthRenderbuffer = 0;
+	int targetWidth = 0;
+	int targetHeight = 0;
+
+	unsigned int headTexture = 0;
+	unsigned int headClearPBO = 0;
+	unsigned int nodeBuffer = 0;
+	unsigned int counterBuffer = 0;
+	unsigned int nodeCapacity = 0;
+	int listWidth = 0;
+	int listHeight = 0;
+
+	std::unique_ptr<Shader> sortedShader;
+	std::unique_ptr<Shader> accumulateShader;
+	std::unique_ptr<Shader> compositeShader;
+	std::unique_ptr<Shader> linkedListShader;
+	std::unique_ptr<Shader> resolveShader;
+};
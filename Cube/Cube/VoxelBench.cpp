@@ -0,0 +1,250 @@
+// voxel_bench: masoara lumea de voxeli fara fereastra si fara OpenGL:
+//   - memoria pe milion de voxeli pentru stocarea directa si cea cu paleta
+//   - timpul de meshing pe chunk si triunghiurile pe chunk (cuburi separate / fete vizibile / greedy)
+//   - re-meshing-ul complet pe fire de lucru si latenta unei singure modificari de voxel
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glm.hpp>
+
+#include "VoxelWorld.h"
+#include "ChunkMesher.h"
+
+struct Percentiles
+{
+	double mean = 0.0;
+	double p50 = 0.0;
+	double p95 = 0.0;
+	double max = 0.0;
+};
+
+Percentiles ComputePercentiles(std::vector<double> values)
+{
+	Percentiles result;
+	if (values.empty())
+		return result;
+
+	std::sort(values.begin(), values.end());
+	for (double value : values)
+		result.mean += value;
+	result.mean /= values.size();
+	result.p50 = values[(values.size() - 1) / 2];
+	result.p95 = values[(size_t)(0.95 * (values.size() - 1) + 0.5)];
+	result.max = values.back();
+	return result;
+}
+
+double ElapsedMs(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void BenchStorage(int sizeX, int sizeY, int sizeZ)
+{
+	const double volume = (double)sizeX * sizeY * sizeZ;
+
+	std::cout << "storage\tchunks\tsolid\tgen_ms\tMB\tbytes_per_Mvoxel\tbytes_per_Msolid" << std::endl;
+	for (EChunkStorage storage : { EChunkStorage::CHUNK_DENSE, EChunkStorage::CHUNK_PALETTE })
+	{
+		VoxelWorld world(storage);
+		auto start = std::chrono::steady_clock::now();
+		GenerateTestTerrain(world, sizeX, sizeY, sizeZ);
+		const double genMs = ElapsedMs(start);
+
+		const double bytes = (double)world.GetMemoryBytes();
+		const double solid = (double)world.GetSolidCount();
+		std::cout << GetChunkStorageName(storage) << "\t" << world.GetChunkCount() << "\t" << (size_t)solid << "\t" << genMs
+			<< "\t" << bytes / (1024.0 * 1024.0) << "\t" << bytes / volume * 1.0e6 << "\t" << bytes / solid * 1.0e6 << std::endl;
+
+		if (storage == EChunkStorage::CHUNK_PALETTE)
+		{
+			// cati biti pe voxel au ramas dupa Optimize
+			int histogram[17] = {};
+			for (const glm::ivec3& coord : world.GetChunkCoords())
+				++histogram[world.FindChunk(coord)->GetBitsPerVoxel()];
+			std::cout << "  palette bits per voxel:";
+			for (int bits = 0; bits <= 16; ++bits)
+			{
+				if (histogram[bits])
+					std::cout << "  " << bits << "b x" << histogram[bits];
+			}
+			std::cout << std::endl;
+		}
+	}
+
+	// referinta: campul de cuburi instantiate din GpuCulling.h tine un vec4 per cub in
+	// bufferul de bounding-uri si inca unul in bufferul instantelor vizibile
+	std::cout << "instanced field reference: " << 2 * sizeof(glm::vec4) * 1.0e6 << " bytes_per_Msolid" << std::endl;
+}
+
+void BenchMeshing(const VoxelWorld& world)
+{
+	std::vector<glm::ivec3> coords;
+	for (const glm::ivec3& coord : world.GetChunkCoords())
+	{
+		if (!world.FindChunk(coord)->IsEmpty())
+			coords.push_back(coord);
+	}
+	const double solid = (double)world.GetSolidCount();
+
+	// copiile cu margine sunt aceleasi pentru ambele moduri
+	std::vector<std::vector<VoxelId>> padded(coords.size());
+	std::vector<double> copyMs;
+	for (size_t i = 0; i < coords.size(); ++i)
+	{
+		auto start = std::chrono::steady_clock::now();
+		world.CopyPaddedChunk(coords[i], padded[i]);
+		copyMs.push_back(ElapsedMs(start));
+	}
+	const Percentiles copy = ComputePercentiles(copyMs);
+
+	std::cout << std::endl << coords.size() << " non-empty chunks, copy with border: mean " << copy.mean << " ms, p95 " << copy.p95 << " ms" << std::endl;
+	std::cout << "mode\tmesh_ms_mean\tmesh_ms_p50\tmesh_ms_p95\tmesh_ms_max\ttris_per_chunk\ttris_max\ttotal_tris\tvertex_MB\tvertex_bytes_per_Msolid" << std::endl;
+
+	// fara meshing: 36 de varfuri de 24 de octeti pentru fiecare cub, ca in Cube.cpp
+	std::cout << "separate cubes\t-\t-\t-\t-\t" << solid * 12.0 / coords.size() << "\t-\t" << (size_t)(solid * 12.0) << "\t"
+		<< solid * 36 * 24 / (1024.0 * 1024.0) << "\t" << 36 * 24 * 1.0e6 << std::endl;
+
+	std::vector<VoxelVertex> vertices;
+	for (EMeshingMode mode : { EMeshingMode::MESH_CULLED_FACES, EMeshingMode::MESH_GREEDY })
+	{
+		std::vector<double> meshMs;
+		size_t totalTriangles = 0, maxTriangles = 0;
+		for (size_t i = 0; i < coords.size(); ++i)
+		{
+			auto start = std::chrono::steady_clock::now();
+			MeshChunk(padded[i], mode, vertices);
+			meshMs.push_back(ElapsedMs(start));
+
+			const size_t triangles = vertices.size() / 2;
+			totalTriangles += triangles;
+			maxTriangles = std::max(maxTriangles, triangles);
+		}
+
+		const Percentiles mesh = ComputePercentiles(meshMs);
+		const double vertexBytes = totalTriangles * 2.0 * sizeof(VoxelVertex);
+		std::cout << GetMeshingModeName(mode) << "\t" << mesh.mean << "\t" << mesh.p50 << "\t" << mesh.p95 << "\t" << mesh.max
+			<< "\t" << (double)totalTriangles / coords.size() << "\t" << maxTriangles << "\t" << totalTriangles
+			<< "\t" << vertexBytes / (1024.0 * 1024.0) << "\t" << vertexBytes / solid * 1.0e6 << std::endl;
+	}
+}
+
+// Re-meshing-ul intregii lumi, cu un fir si cu threadCount fire.
+void BenchFullRemesh(const VoxelWorld& world, int threadCount)
+{
+	const std::vector<glm::ivec3> coords = world.GetChunkCoords();
+
+	std::cout << std::endl << "threads\tfull_remesh_ms\tchunks_per_s" << std::endl;
+	for (int threads : { 1, threadCount })
+	{
+		ChunkMeshWorkers workers(EMeshingMode::MESH_GREEDY, threads);
+		auto start = std::chrono::steady_clock::now();
+		for (const glm::ivec3& coord : coords)
+			workers.Submit(world, coord);
+		workers.WaitIdle();
+		const double ms = ElapsedMs(start);
+
+		ChunkMesh mesh;
+		while (workers.TryPop(mesh))
+			workers.Recycle(mesh);
+		std::cout << workers.GetThreadCount() << "\t" << ms << "\t" << coords.size() / (ms / 1000.0) << std::endl;
+
+		if (threads == threadCount)
+			break;
+	}
+}
+
+// Modificari aleatoare de cate un voxel langa suprafata: timpul de la SetVoxel pana la
+// mesh-urile tuturor chunk-urilor afectate, pe firele de lucru.
+void BenchEdits(VoxelWorld& world, int sizeX, int sizeY, int sizeZ, int threadCount, int editCount)
+{
+	ChunkMeshWorkers workers(EMeshingMode::MESH_GREEDY, threadCount);
+	std::vector<glm::ivec3> dirty;
+	world.TakeDirtyChunks(dirty);
+
+	std::mt19937 random(1234);
+	std::uniform_int_distribution<int> randomX(0, sizeX - 1), randomZ(0, sizeZ - 1);
+
+	std::vector<double> editMs;
+	size_t remeshedChunks = 0;
+	for (int edit = 0; edit < editCount; ++edit)
+	{
+		// primul voxel de aer de sus in jos: sapa in suprafata sau umple locul de deasupra ei
+		const int x = randomX(random), z = randomZ(random);
+		int y = sizeY - 1;
+		while (y > 0 && world.GetVoxel(glm::ivec3(x, y, z)) == VOXEL_AIR)
+			--y;
+		const glm::ivec3 voxel(x, edit % 2 == 0 ? y : std::min(y + 1, sizeY - 1), z);
+		const VoxelId id = world.GetVoxel(voxel) == VOXEL_AIR ? 1 : VOXEL_AIR;
+
+		auto start = std::chrono::steady_clock::now();
+		world.SetVoxel(voxel, id);
+		world.TakeDirtyChunks(dirty);
+		for (const glm::ivec3& coord : dirty)
+			workers.Submit(world, coord);
+		workers.WaitIdle();
+
+		ChunkMesh mesh;
+		while (workers.TryPop(mesh))
+			workers.Recycle(mesh);
+		editMs.push_back(ElapsedMs(start));
+		remeshedChunks += dirty.size();
+	}
+
+	const Percentiles edits = ComputePercentiles(editMs);
+	std::cout << std::endl << editCount << " single-voxel edits on " << workers.GetThreadCount() << " threads: "
+		<< (double)remeshedChunks / std::max(editCount, 1) << " chunks remeshed per edit, latency mean " << edits.mean
+		<< " ms, p50 " << edits.p50 << " ms, p95 " << edits.p95 << " ms, max " << edits.max << " ms" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	int size = 256;
+	int threadCount = 0;
+	int editCount = 200;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string strArg = argv[i];
+		if (strArg == "--size" && i + 1 < argc)
+			size = atoi(argv[++i]);
+		else if (strArg == "--threads" && i + 1 < argc)
+			threadCount = atoi(argv[++i]);
+		else if (strArg == "--edits" && i + 1 < argc)
+			editCount = atoi(argv[++i]);
+		else
+		{
+			std::cout << "usage: voxel_bench [--size N] [--threads N] [--edits N]" << std::endl;
+			return 1;
+		}
+	}
+
+	if (size <= 0 || editCount < 0)
+	{
+		std::cout << "--size must be positive" << std::endl;
+		return 1;
+	}
+	if (threadCount <= 0)
+		threadCount = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+
+	// aceeasi lume ca aplicatia cu --voxels N
+	const int sizeX = size, sizeY = std::max(size / 2, 1), sizeZ = size;
+	std::cout << "voxel_bench: world " << sizeX << "x" << sizeY << "x" << sizeZ << ", chunks " << CHUNK_SIZE << "^3" << std::endl;
+	std::cout << std::fixed << std::setprecision(3);
+
+	BenchStorage(sizeX, sizeY, sizeZ);
+
+	VoxelWorld world(EChunkStorage::CHUNK_PALETTE);
+	GenerateTestTerrain(world, sizeX, sizeY, sizeZ);
+
+	BenchMeshing(world);
+	BenchFullRemesh(world, threadCount);
+	BenchEdits(world, sizeX, sizeY, sizeZ, threadCount, editCount);
+	return 0;
+}
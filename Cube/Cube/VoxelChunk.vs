@@ -0,0 +1,45 @@
+#version 330 core
+layout(location = 0) in uint aPosition;
+layout(location = 1) in uint aMaterial;
+
+out vec3 FragPos;
+out vec3 objectColor;
+out vec3 Normal;
+#ifdef TEMPORAL_CACHE
+out vec4 PrevClipPos;
+#endif
+
+uniform mat4 view;
+uniform mat4 projection;
+#ifdef TEMPORAL_CACHE
+// geometria este statica, deci doar camera anterioara conteaza la reproiectare
+uniform mat4 prevViewProjection;
+#endif
+uniform vec3 chunkOrigin;
+
+const vec3 faceNormals[6] = vec3[6](
+    vec3(1.0, 0.0, 0.0), vec3(-1.0, 0.0, 0.0),
+    vec3(0.0, 1.0, 0.0), vec3(0.0, -1.0, 0.0),
+    vec3(0.0, 0.0, 1.0), vec3(0.0, 0.0, -1.0));
+
+// culorile materialelor din GenerateTestTerrain: piatra, pamant, iarba
+const vec3 materialColors[4] = vec3[4](
+    vec3(1.0, 0.0, 1.0), vec3(0.5, 0.5, 0.55), vec3(0.45, 0.3, 0.15), vec3(0.3, 0.7, 0.2));
+
+void main()
+{
+    // vezi PackVoxelVertex din ChunkMesher.h
+    vec3 localPos = vec3(aPosition & 63u, (aPosition >> 6) & 63u, (aPosition >> 12) & 63u);
+    FragPos = chunkOrigin + localPos;
+    Normal = faceNormals[(aPosition >> 18) & 7u];
+
+    if (aMaterial < 4u)
+        objectColor = materialColors[aMaterial];
+    else
+        objectColor = vec3((aMaterial * 97u) % 255u, (aMaterial * 57u) % 255u, (aMaterial * 31u) % 255u) / 255.0;
+
+#ifdef TEMPORAL_CACHE
+    PrevClipPos = prevViewProjection * vec4(FragPos, 1.0);
+#endif
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
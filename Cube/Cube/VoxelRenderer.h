@@ -0,0 +1,213 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include <GL/glew.h>
+#include <glm.hpp>
+
+#include "Shader.h"
+#include "CubeField.h"
+#include "VoxelWorld.h"
+#include "ChunkMesher.h"
+#include "GpuMemory.h"
+
+// Deseneaza o VoxelWorld: cate un VBO cu varfuri compacte pe chunk, un index buffer comun
+// pentru quad-uri si culling pe chunk-uri. O modificare a lumii re-mesheaza doar chunk-urile
+// atinse, pe firele ChunkMeshWorkers; pana soseste noul mesh se deseneaza cel vechi.
+class VoxelRenderer
+{
+public:
+	// worldOrigin = pozitia in scena a voxelului (0, 0, 0)
+	VoxelRenderer(VoxelWorld& world, const glm::vec3& worldOrigin, int threadCount = 0)
+		: world(world), worldOrigin(worldOrigin), workers(EMeshingMode::MESH_GREEDY, threadCount)
+	{
+		Init();
+	}
+
+	~VoxelRenderer()
+	{
+		for (auto& chunk : gpuChunks)
+		{
+			glDeleteVertexArrays(1, &chunk.second.VAO);
+			GpuDeleteBuffers(1, &chunk.second.VBO);
+		}
+		GpuDeleteBuffers(1, &quadIndexBuffer);
+	}
+
+	VoxelWorld& GetWorld()
+	{
+		return world;
+	}
+
+	glm::ivec3 GetVoxelAt(const glm::vec3& position) const
+	{
+		return glm::ivec3(glm::floor(position - worldOrigin));
+	}
+
+	// Trimite chunk-urile modificate la meshing si incarca mesh-urile terminate intre timp.
+	// Intoarce true daca a trimis sau a incarcat ceva (cozile si chunk-urile noi aloca memorie).
+	bool Update()
+	{
+		world.TakeDirtyChunks(dirtyScratch);
+		for (const glm::ivec3& coord : dirtyScratch)
+			workers.Submit(world, coord);
+		bool bChanged = !dirtyScratch.empty();
+
+		ChunkMesh mesh;
+		while (workers.TryPop(mesh))
+		{
+			Upload(mesh);
+			workers.Recycle(mesh);
+			bChanged = true;
+		}
+		return bChanged;
+	}
+
+	// Shaderul (VoxelChunk.vs) trebuie sa fie activ, cu projection si view setate.
+	void Draw(const Shader& shader, const glm::mat4& projection, const glm::mat4& view)
+	{
+		glm::vec4 planes[6];
+		ExtractFrustumPlanes(projection * view, planes);
+
+		const GLint chunkOriginLocation = shader.GetUniformLocation("chunkOrigin");
+		const float halfChunk = CHUNK_SIZE * 0.5f;
+
+		drawnChunks = 0;
+		drawnTriangles = 0;
+		for (const auto& chunk : gpuChunks)
+		{
+			const GpuChunk& gpuChunk = chunk.second;
+			if (gpuChunk.vertexCount == 0)
+				continue;
+
+			const glm::vec3 origin = worldOrigin + glm::vec3(chunk.first * CHUNK_SIZE);
+			if (!IsInstanceVisible(planes, glm::vec4(origin + halfChunk, (float)CHUNK_SIZE)))
+				continue;
+
+			glUniform3f(chunkOriginLocation, origin.x, origin.y, origin.z);
+			glBindVertexArray(gpuChunk.VAO);
+			glDrawElements(GL_TRIANGLES, gpuChunk.vertexCount / 4 * 6, GL_UNSIGNED_INT, (void*)0);
+
+			++drawnChunks;
+			drawnTriangles += gpuChunk.vertexCount / 2;
+		}
+		glBindVertexArray(0);
+	}
+
+	size_t GetDrawnChunks() const
+	{
+		return drawnChunks;
+	}
+
+	size_t GetDrawnTriangles() const
+	{
+		return drawnTriangles;
+	}
+
+	size_t GetPendingChunks()
+	{
+		return workers.GetPendingCount();
+	}
+
+	size_t GetPoolMisses()
+	{
+		return workers.GetPoolMisses();
+	}
+
+	size_t GetPooledBytes()
+	{
+		return workers.GetPooledBytes();
+	}
+
+private:
+	struct GpuChunk
+	{
+		unsigned int VAO = 0;
+		unsigned int VBO = 0;
+		unsigned int vertexCount = 0;
+		uint64_t revision = 0;
+	};
+
+	void Init()
+	{
+		drawnChunks = 0;
+		drawnTriangles = 0;
+		quadCapacity = 0;
+		glGenBuffers(1, &quadIndexBuffer);
+		EnsureQuadIndices(CHUNK_SIZE * CHUNK_SIZE * 6);
+	}
+
+	// Indicii 0 1 2 2 3 0 pentru fiecare quad; bufferul creste la cel mai mare mesh vazut.
+	// Numele bufferului ramane acelasi, deci VAO-urile existente vad automat noul continut.
+	void EnsureQuadIndices(size_t quadCount)
+	{
+		if (quadCount <= quadCapacity)
+			return;
+
+		quadCapacity = std::max(quadCount, quadCapacity * 2);
+		std::vector<GLuint> indices(quadCapacity * 6);
+		for (size_t quad = 0; quad < quadCapacity; ++quad)
+		{
+			const GLuint first = (GLuint)(quad * 4);
+			GLuint* pQuad = &indices[quad * 6];
+			pQuad[0] = first;
+			pQuad[1] = first + 1;
+			pQuad[2] = first + 2;
+			pQuad[3] = first + 2;
+			pQuad[4] = first + 3;
+			pQuad[5] = first;
+		}
+
+		glBindVertexArray(0);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadIndexBuffer);
+		GpuBufferData(GL_ELEMENT_ARRAY_BUFFER, quadIndexBuffer, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	}
+
+	void Upload(const ChunkMesh& mesh)
+	{
+		GpuChunk& gpuChunk = gpuChunks[mesh.coord];
+		// mesh-urile pot sosi in alta ordine decat au fost trimise; unul mai vechi se ignora
+		if (mesh.revision < gpuChunk.revision)
+			return;
+		gpuChunk.revision = mesh.revision;
+
+		EnsureQuadIndices(mesh.vertices.size() / 4);
+
+		if (gpuChunk.VAO == 0)
+		{
+			glGenVertexArrays(1, &gpuChunk.VAO);
+			glGenBuffers(1, &gpuChunk.VBO);
+			glBindVertexArray(gpuChunk.VAO);
+			glBindBuffer(GL_ARRAY_BUFFER, gpuChunk.VBO);
+			glVertexAttribIPointer(0, 1, GL_UNSIGNED_INT, sizeof(VoxelVertex), (void*)offsetof(VoxelVertex, position));
+			glEnableVertexAttribArray(0);
+			glVertexAttribIPointer(1, 1, GL_UNSIGNED_INT, sizeof(VoxelVertex), (void*)offsetof(VoxelVertex, material));
+			glEnableVertexAttribArray(1);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadIndexBuffer);
+			glBindVertexArray(0);
+		}
+
+		gpuChunk.vertexCount = (unsigned int)mesh.vertices.size();
+		glBindBuffer(GL_ARRAY_BUFFER, gpuChunk.VBO);
+		GpuBufferData(GL_ARRAY_BUFFER, gpuChunk.VBO, mesh.vertices.size() * sizeof(VoxelVertex), mesh.vertices.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+private:
+	VoxelWorld& world;
+	glm::vec3 worldOrigin;
+	ChunkMeshWorkers workers;
+
+	unsigned int quadIndexBuffer;
+	size_t quadCapacity;
+
+	std::unordered_map<glm::ivec3, GpuChunk, ChunkCoordHash> gpuChunks;
+	std::vector<glm::ivec3> dirtyScratch;
+
+	size_t drawnChunks;
+	size_t drawnTriangles;
+};
@@ -0,0 +1,587 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <glm.hpp>
+
+// Lume de cuburi unitare impartita in chunk-uri de 32^3 voxeli.
+// Nu depinde de OpenGL, asa ca poate fi folosita si de voxel_bench.
+
+typedef uint16_t VoxelId;
+
+const VoxelId VOXEL_AIR = 0;
+const int CHUNK_SIZE = 32;
+const int CHUNK_VOLUME = CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE;
+
+enum EChunkStorage
+{
+	CHUNK_DENSE,
+	CHUNK_PALETTE
+};
+
+inline const char* GetChunkStorageName(EChunkStorage storage)
+{
+	switch (storage)
+	{
+	case EChunkStorage::CHUNK_DENSE:
+		return "dense";
+	case EChunkStorage::CHUNK_PALETTE:
+		return "palette";
+	}
+	return "unknown";
+}
+
+// x variaza cel mai repede, apoi z, apoi y
+inline int GetVoxelIndex(int x, int y, int z)
+{
+	return (y * CHUNK_SIZE + z) * CHUNK_SIZE + x;
+}
+
+// Un chunk pastreaza voxelii fie direct (2 octeti / voxel), fie ca indici intr-o paleta
+// locala impachetati pe 0, 1, 2, 4 sau 8 biti. Un chunk uniform (de exemplu doar aer)
+// nu ocupa deloc memorie pentru indici. Daca paleta depaseste 256 de intrari, chunk-ul
+// trece singur pe stocarea directa.
+class VoxelChunk
+{
+public:
+	explicit VoxelChunk(EChunkStorage storage)
+	{
+		Init(storage);
+	}
+
+	EChunkStorage GetStorage() const
+	{
+		return storage;
+	}
+
+	int GetSolidCount() const
+	{
+		return solidCount;
+	}
+
+	bool IsEmpty() const
+	{
+		return solidCount == 0;
+	}
+
+	int GetBitsPerVoxel() const
+	{
+		return storage == EChunkStorage::CHUNK_DENSE ? 16 : bitsPerIndex;
+	}
+
+	size_t GetPaletteSize() const
+	{
+		return palette.size();
+	}
+
+	VoxelId Get(int x, int y, int z) const
+	{
+		const int index = GetVoxelIndex(x, y, z);
+		if (storage == EChunkStorage::CHUNK_DENSE)
+			return dense[index];
+		return palette[ReadIndex(index)];
+	}
+
+	// Intoarce false daca voxelul avea deja valoarea ceruta.
+	bool Set(int x, int y, int z, VoxelId id)
+	{
+		const int index = GetVoxelIndex(x, y, z);
+		const VoxelId previous = storage == EChunkStorage::CHUNK_DENSE ? dense[index] : palette[ReadIndex(index)];
+		if (previous == id)
+			return false;
+
+		solidCount += (id != VOXEL_AIR) - (previous != VOXEL_AIR);
+
+		if (storage == EChunkStorage::CHUNK_DENSE)
+		{
+			dense[index] = id;
+			return true;
+		}
+
+		--paletteCounts[ReadIndex(index)];
+		const unsigned int entry = FindOrAddPaletteEntry(id);
+		if (storage == EChunkStorage::CHUNK_DENSE)
+		{
+			// paleta a depasit 256 de intrari si chunk-ul a fost convertit
+			dense[index] = id;
+			return true;
+		}
+		++paletteCounts[entry];
+		WriteIndex(index, entry);
+		return true;
+	}
+
+	// Scrie toti voxelii chunk-ului in ordinea GetVoxelIndex.
+	void Decode(VoxelId* out) const
+	{
+		if (storage == EChunkStorage::CHUNK_DENSE)
+		{
+			std::copy(dense.begin(), dense.end(), out);
+			return;
+		}
+		if (bitsPerIndex == 0)
+		{
+			std::fill(out, out + CHUNK_VOLUME, palette[0]);
+			return;
+		}
+
+		const int perWord = 64 / bitsPerIndex;
+		const uint64_t mask = (1ull << bitsPerIndex) - 1;
+		for (size_t word = 0; word < indices.size(); ++word)
+		{
+			uint64_t bits = indices[word];
+			VoxelId* pOut = out + word * perWord;
+			for (int i = 0; i < perWord; ++i, bits >>= bitsPerIndex)
+				pOut[i] = palette[(size_t)(bits & mask)];
+		}
+	}
+
+	// Elimina intrarile nefolosite din paleta si reimpacheteaza indicii pe cat mai putini biti.
+	// Se apeleaza dupa modificari in masa (generarea lumii), nu dupa fiecare Set.
+	void Optimize()
+	{
+		if (storage == EChunkStorage::CHUNK_DENSE)
+			return;
+
+		std::vector<uint8_t> entries(CHUNK_VOLUME);
+		DecodeIndices(entries.data());
+
+		// noua pozitie a fiecarei intrari folosite; paleta are cel mult 256 de intrari
+		uint8_t remap[256] = {};
+		std::vector<VoxelId> usedPalette;
+		std::vector<uint32_t> usedCounts;
+		for (size_t i = 0; i < palette.size(); ++i)
+		{
+			if (paletteCounts[i] == 0)
+				continue;
+			remap[i] = (uint8_t)usedPalette.size();
+			usedPalette.push_back(palette[i]);
+			usedCounts.push_back(paletteCounts[i]);
+		}
+		for (uint8_t& entry : entries)
+			entry = remap[entry];
+
+		palette.swap(usedPalette);
+		paletteCounts.swap(usedCounts);
+		palette.shrink_to_fit();
+		paletteCounts.shrink_to_fit();
+		Repack(GetBitsForPaletteSize(palette.size()), entries.data());
+	}
+
+	// Memoria ocupata de chunk, inclusiv alocarile lui.
+	size_t GetMemoryBytes() const
+	{
+		return sizeof(*this) + dense.capacity() * sizeof(VoxelId) + indices.capacity() * sizeof(uint64_t) +
+			palette.capacity() * sizeof(VoxelId) + paletteCounts.capacity() * sizeof(uint32_t);
+	}
+
+private:
+	void Init(EChunkStorage storage)
+	{
+		this->storage = storage;
+		this->solidCount = 0;
+		this->bitsPerIndex = 0;
+
+		if (storage == EChunkStorage::CHUNK_DENSE)
+		{
+			dense.assign(CHUNK_VOLUME, VOXEL_AIR);
+		}
+		else
+		{
+			palette.push_back(VOXEL_AIR);
+			paletteCounts.push_back(CHUNK_VOLUME);
+		}
+	}
+
+	static int GetBitsForPaletteSize(size_t paletteSize)
+	{
+		// latimi care divid 64, ca un indice sa nu fie niciodata impartit intre doua cuvinte
+		int bits = 0;
+		while (((size_t)1 << bits) < paletteSize)
+			bits = bits == 0 ? 1 : bits * 2;
+		return bits;
+	}
+
+	unsigned int ReadIndex(int index) const
+	{
+		if (bitsPerIndex == 0)
+			return 0;
+		const int bitOffset = index * bitsPerIndex;
+		return (unsigned int)((indices[bitOffset >> 6] >> (bitOffset & 63)) & ((1ull << bitsPerIndex) - 1));
+	}
+
+	void WriteIndex(int index, unsigned int entry)
+	{
+		if (bitsPerIndex == 0)
+			return;
+		const int bitOffset = index * bitsPerIndex;
+		const uint64_t mask = ((1ull << bitsPerIndex) - 1) << (bitOffset & 63);
+		uint64_t& word = indices[bitOffset >> 6];
+		word = (word & ~mask) | ((uint64_t)entry << (bitOffset & 63));
+	}
+
+	unsigned int FindOrAddPaletteEntry(VoxelId id)
+	{
+		int freeEntry = -1;
+		for (size_t i = 0; i < palette.size(); ++i)
+		{
+			if (palette[i] == id)
+				return (unsigned int)i;
+			if (freeEntry < 0 && paletteCounts[i] == 0)
+				freeEntry = (int)i;
+		}
+
+		// o intrare ramasa fara voxeli se refoloseste inainte de a mari paleta
+		if (freeEntry >= 0)
+		{
+			palette[freeEntry] = id;
+			return (unsigned int)freeEntry;
+		}
+
+		if (palette.size() >= 256)
+		{
+			ConvertToDense();
+			return 0;
+		}
+
+		const int requiredBits = GetBitsForPaletteSize(palette.size() + 1);
+		if (requiredBits != bitsPerIndex)
+		{
+			std::vector<uint8_t> entries(CHUNK_VOLUME);
+			DecodeIndices(entries.data());
+			palette.push_back(id);
+			paletteCounts.push_back(0);
+			Repack(requiredBits, entries.data());
+		}
+		else
+		{
+			palette.push_back(id);
+			paletteCounts.push_back(0);
+		}
+		return (unsigned int)(palette.size() - 1);
+	}
+
+	// Indicii in paleta ai tuturor voxelilor, in ordinea GetVoxelIndex.
+	void DecodeIndices(uint8_t* out) const
+	{
+		if (bitsPerIndex == 0)
+		{
+			std::fill(out, out + CHUNK_VOLUME, (uint8_t)0);
+			return;
+		}
+
+		const int perWord = 64 / bitsPerIndex;
+		const uint64_t mask = (1ull << bitsPerIndex) - 1;
+		for (size_t word = 0; word < indices.size(); ++word)
+		{
+			uint64_t bits = indices[word];
+			uint8_t* pOut = out + word * perWord;
+			for (int i = 0; i < perWord; ++i, bits >>= bitsPerIndex)
+				pOut[i] = (uint8_t)(bits & mask);
+		}
+	}
+
+	// Reimpacheteaza pe latimea data indicii produsi de DecodeIndices (eventual renumerotati).
+	void Repack(int bits, const uint8_t* entries)
+	{
+		bitsPerIndex = bits;
+		indices.clear();
+		if (bits == 0)
+		{
+			indices.shrink_to_fit();
+			return;
+		}
+		indices.assign((size_t)CHUNK_VOLUME * bits / 64, 0);
+		indices.shrink_to_fit();
+
+		const int perWord = 64 / bits;
+		for (size_t word = 0; word < indices.size(); ++word)
+		{
+			const uint8_t* pEntries = entries + word * perWord;
+			uint64_t packed = 0;
+			for (int i = 0; i < perWord; ++i)
+				packed |= (uint64_t)pEntries[i] << (i * bits);
+			indices[word] = packed;
+		}
+	}
+
+	void ConvertToDense()
+	{
+		dense.resize(CHUNK_VOLUME);
+		Decode(dense.data());
+
+		storage = EChunkStorage::CHUNK_DENSE;
+		bitsPerIndex = 0;
+		std::vector<uint64_t>().swap(indices);
+		std::vector<VoxelId>().swap(palette);
+		std::vector<uint32_t>().swap(paletteCounts);
+	}
+
+private:
+	EChunkStorage storage;
+	int solidCount;
+	int bitsPerIndex;
+
+	std::vector<VoxelId> dense;
+	std::vector<uint64_t> indices;
+	std::vector<VoxelId> palette;
+	std::vector<uint32_t> paletteCounts;
+};
+
+struct ChunkCoordHash
+{
+	size_t operator()(const glm::ivec3& coord) const
+	{
+		return ((size_t)(uint32_t)coord.x * 73856093u) ^ ((size_t)(uint32_t)coord.y * 19349663u) ^ ((size_t)(uint32_t)coord.z * 83492791u);
+	}
+};
+
+// Latura unui voxel este 1; voxelul (x, y, z) ocupa cubul [x, x + 1] x [y, y + 1] x [z, z + 1].
+// Fiecare modificare marcheaza ca "murdare" chunk-ul ei si vecinii cu care are o fata comuna,
+// pentru ca fetele vizibile de la granita depind de ambele chunk-uri.
+class VoxelWorld
+{
+public:
+	explicit VoxelWorld(EChunkStorage storage)
+		: storage(storage)
+	{
+	}
+
+	EChunkStorage GetStorage() const
+	{
+		return storage;
+	}
+
+	static glm::ivec3 GetChunkCoord(const glm::ivec3& voxel)
+	{
+		return glm::ivec3(FloorDiv(voxel.x), FloorDiv(voxel.y), FloorDiv(voxel.z));
+	}
+
+	const VoxelChunk* FindChunk(const glm::ivec3& coord) const
+	{
+		auto it = chunks.find(coord);
+		return it != chunks.end() ? it->second.pChunk.get() : nullptr;
+	}
+
+	VoxelId GetVoxel(const glm::ivec3& voxel) const
+	{
+		const glm::ivec3 coord = GetChunkCoord(voxel);
+		const VoxelChunk* pChunk = FindChunk(coord);
+		if (!pChunk)
+			return VOXEL_AIR;
+		const glm::ivec3 local = voxel - coord * CHUNK_SIZE;
+		return pChunk->Get(local.x, local.y, local.z);
+	}
+
+	bool SetVoxel(const glm::ivec3& voxel, VoxelId id)
+	{
+		const glm::ivec3 coord = GetChunkCoord(voxel);
+		auto it = chunks.find(coord);
+		if (it == chunks.end())
+		{
+			if (id == VOXEL_AIR)
+				return false;
+			ChunkEntry entry;
+			entry.pChunk.reset(new VoxelChunk(storage));
+			it = chunks.emplace(coord, std::move(entry)).first;
+		}
+
+		const glm::ivec3 local = voxel - coord * CHUNK_SIZE;
+		if (!it->second.pChunk->Set(local.x, local.y, local.z, id))
+			return false;
+
+		MarkDirty(coord);
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			glm::ivec3 offset(0);
+			if (local[axis] == 0)
+				offset[axis] = -1;
+			else if (local[axis] == CHUNK_SIZE - 1)
+				offset[axis] = 1;
+			else
+				continue;
+			if (chunks.count(coord + offset))
+				MarkDirty(coord + offset);
+		}
+		return true;
+	}
+
+	// Chunk-urile modificate de la ultimul apel, fiecare o singura data.
+	void TakeDirtyChunks(std::vector<glm::ivec3>& dirty)
+	{
+		dirty.clear();
+		dirty.swap(dirtyChunks);
+		for (const glm::ivec3& coord : dirty)
+			chunks[coord].bDirty = false;
+	}
+
+	// Numarul modificarii curente a chunk-ului; un mesh mai vechi decat el este depasit.
+	uint64_t GetRevision(const glm::ivec3& coord) const
+	{
+		auto it = chunks.find(coord);
+		return it != chunks.end() ? it->second.revision : 0;
+	}
+
+	// Voxelii chunk-ului plus un strat din vecinii de pe fiecare fata, intr-un bloc
+	// (CHUNK_SIZE + 2)^3 indexat cu GetPaddedIndex. Copia permite meshing-ul pe alte fire
+	// in timp ce lumea continua sa fie modificata.
+	void CopyPaddedChunk(const glm::ivec3& coord, std::vector<VoxelId>& padded) const
+	{
+		padded.assign((size_t)PADDED_SIZE * PADDED_SIZE * PADDED_SIZE, VOXEL_AIR);
+
+		const VoxelChunk* pChunk = FindChunk(coord);
+		if (!pChunk)
+			return;
+
+		std::vector<VoxelId> voxels(CHUNK_VOLUME);
+		pChunk->Decode(voxels.data());
+		for (int y = 0; y < CHUNK_SIZE; ++y)
+		{
+			for (int z = 0; z < CHUNK_SIZE; ++z)
+			{
+				const VoxelId* pRow = &voxels[GetVoxelIndex(0, y, z)];
+				std::copy(pRow, pRow + CHUNK_SIZE, &padded[GetPaddedIndex(0, y, z)]);
+			}
+		}
+
+		// fetele vecinilor; muchiile si colturile nu influenteaza vizibilitatea fetelor
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			for (int side = -1; side <= 1; side += 2)
+			{
+				glm::ivec3 offset(0);
+				offset[axis] = side;
+				const VoxelChunk* pNeighbour = FindChunk(coord + offset);
+				if (!pNeighbour || pNeighbour->IsEmpty())
+					continue;
+
+				const int source = side < 0 ? CHUNK_SIZE - 1 : 0;
+				const int target = side < 0 ? -1 : CHUNK_SIZE;
+				const int uAxis = (axis + 1) % 3;
+				const int vAxis = (axis + 2) % 3;
+				for (int v = 0; v < CHUNK_SIZE; ++v)
+				{
+					for (int u = 0; u < CHUNK_SIZE; ++u)
+					{
+						glm::ivec3 from, to;
+						from[axis] = source;
+						to[axis] = target;
+						from[uAxis] = to[uAxis] = u;
+						from[vAxis] = to[vAxis] = v;
+						padded[GetPaddedIndex(to.x, to.y, to.z)] = pNeighbour->Get(from.x, from.y, from.z);
+					}
+				}
+			}
+		}
+	}
+
+	static int GetPaddedIndex(int x, int y, int z)
+	{
+		return ((y + 1) * PADDED_SIZE + (z + 1)) * PADDED_SIZE + (x + 1);
+	}
+
+	std::vector<glm::ivec3> GetChunkCoords() const
+	{
+		std::vector<glm::ivec3> coords;
+		coords.reserve(chunks.size());
+		for (const auto& chunk : chunks)
+			coords.push_back(chunk.first);
+		return coords;
+	}
+
+	size_t GetChunkCount() const
+	{
+		return chunks.size();
+	}
+
+	size_t GetSolidCount() const
+	{
+		size_t solid = 0;
+		for (const auto& chunk : chunks)
+			solid += chunk.second.pChunk->GetSolidCount();
+		return solid;
+	}
+
+	void Optimize()
+	{
+		for (auto& chunk : chunks)
+			chunk.second.pChunk->Optimize();
+	}
+
+	// Memoria voxelilor si a tabelei de chunk-uri (aproximativ, fara overhead-ul alocatorului).
+	size_t GetMemoryBytes() const
+	{
+		size_t bytes = sizeof(*this) + chunks.bucket_count() * sizeof(void*);
+		for (const auto& chunk : chunks)
+			bytes += sizeof(chunk) + chunk.second.pChunk->GetMemoryBytes();
+		return bytes;
+	}
+
+public:
+	static const int PADDED_SIZE = CHUNK_SIZE + 2;
+
+private:
+	struct ChunkEntry
+	{
+		std::unique_ptr<VoxelChunk> pChunk;
+		uint64_t revision = 0;
+		bool bDirty = false;
+	};
+
+	static int FloorDiv(int value)
+	{
+		return value >= 0 ? value / CHUNK_SIZE : -((-value + CHUNK_SIZE - 1) / CHUNK_SIZE);
+	}
+
+	void MarkDirty(const glm::ivec3& coord)
+	{
+		ChunkEntry& entry = chunks[coord];
+		entry.revision = ++revisionCounter;
+		if (!entry.bDirty)
+		{
+			entry.bDirty = true;
+			dirtyChunks.push_back(coord);
+		}
+	}
+
+private:
+	EChunkStorage storage;
+	uint64_t revisionCounter = 0;
+	std::unordered_map<glm::ivec3, ChunkEntry, ChunkCoordHash> chunks;
+	std::vector<glm::ivec3> dirtyChunks;
+};
+
+// Teren de test determinist: dealuri din sinusoide, trei materiale pe inaltime si pesteri.
+// Voxelii ocupa [0, sizeX) x [0, sizeY) x [0, sizeZ).
+inline void GenerateTestTerrain(VoxelWorld& world, int sizeX, int sizeY, int sizeZ)
+{
+	const VoxelId STONE = 1, DIRT = 2, GRASS = 3;
+	for (int x = 0; x < sizeX; ++x)
+	{
+		for (int z = 0; z < sizeZ; ++z)
+		{
+			const float hills = std::sin(x * 0.05f) * std::cos(z * 0.04f) + 0.5f * std::sin((x + z) * 0.11f);
+			const int height = std::min(sizeY, std::max(1, (int)(sizeY * (0.55f + 0.25f * hills))));
+			for (int y = 0; y < height; ++y)
+			{
+				const float cave = std::sin(x * 0.17f) * std::sin(y * 0.23f) * std::sin(z * 0.19f);
+				if (y > 2 && cave > 0.55f)
+					continue;
+
+				VoxelId id = STONE;
+				if (y == height - 1)
+					id = GRASS;
+				else if (y >= height - 4)
+					id = DIRT;
+				world.SetVoxel(glm::ivec3(x, y, z), id);
+			}
+		}
+	}
+	world.Optimize();
+}
@@ -0,0 +1,51 @@
+#!/bin/sh
+# Compara timpii de cadru masurati de cube_bench in Debug, Release si Release+LTO+PGO.
+# Argumentele sunt transmise lui cube_bench (ex. ./bench_configs.sh --field 48), iar
+# CUBE_CMAKE_ARGS se adauga la configurare (ex. CUBE_CMAKE_ARGS=-DGLM_INCLUDE_DIR=...).
+set -e
+
+cd "$(dirname "$0")"
+RESULTS="$PWD/build/bench_results.csv"
+JOBS=$(nproc 2>/dev/null || echo 4)
+
+configure() {
+	preset=$1
+	shift
+	# shellcheck disable=SC2086
+	cmake --preset "$preset" -DCUBE_BUILD_APP=OFF $CUBE_CMAKE_ARGS "$@" >/dev/null
+}
+
+mkdir -p build
+rm -f "$RESULTS"
+
+for preset in debug release; do
+	configure "$preset"
+	cmake --build --preset "$preset" --target cube_bench -j "$JOBS"
+	"build/$preset/cube_bench" --record "$RESULTS" "$@"
+done
+
+# PGO: build instrumentat, antrenare pe alte scenarii decat cel masurat (alt camp, alt traseu
+# al camerei, plus calea sortata), apoi rebuild cu profilul in acelasi director (GCC leaga
+# profilul de calea fisierelor obiect). Astfel castigul raportat nu vine din invatarea exacta
+# a scenariului de referinta.
+TRAINING_RUNS="--field 48 --camera-path 1|--field 32 --camera-path 2 --sorted"
+rm -rf build/pgo/pgo-profile
+configure pgo -DCUBE_PGO=GENERATE
+cmake --build --preset pgo --target cube_bench -j "$JOBS"
+echo "$TRAINING_RUNS" | tr '|' '\n' | while read -r training; do
+	# shellcheck disable=SC2086
+	build/pgo/cube_bench $training --frames 300 >/dev/null
+done
+
+if ls build/pgo/pgo-profile/*.profraw >/dev/null 2>&1; then
+	llvm-profdata merge -output=build/pgo/pgo-profile/cube.profdata build/pgo/pgo-profile/*.profraw
+fi
+
+configure pgo -DCUBE_PGO=USE
+cmake --build --preset pgo --target cube_bench -j "$JOBS"
+build/pgo/cube_bench --record "$RESULTS" "$@"
+
+echo
+echo "PGO trained on: $(echo "$TRAINING_RUNS" | sed 's/|/; /g')"
+echo "Measured on:    cube_bench ${*:-(defaults: --field 64 --camera-path 0)}"
+build/release/cube_bench --compare "$RESULTS"